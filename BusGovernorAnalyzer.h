@@ -0,0 +1,429 @@
+/*
+  ==============================================================================
+
+    BusGovernorAnalyzer - pre/post spectrum, computed off the audio thread.
+
+    BusGovernorAnalyzerTap is the audio-thread part, one per instance. While
+    an analyzer is attached it mixes the block's input and output down to
+    mono into two wait-free single-producer/single-consumer rings (about
+    1 ns per frame for both, stereo); otherwise push() is a single relaxed
+    load. A block that does not fit because the reader has stalled is
+    dropped, never waited for.
+
+    BusGovernorSpectrumAnalyzer is the per-editor part. Each frame it drains
+    both rings into histories of the last fftSize samples, Hann-windows
+    them (juce::dsp::WindowingFunction's table) and runs them through one
+    complex juce::dsp::FFT (input in the real part, output in the imaginary
+    part, separated afterwards), reduces the bins from 1 up (DC is never
+    shown) to numPoints log-spaced points from 20 Hz to 20 kHz, and smooths
+    them in dB (fast rise, slow fall). A full-scale sine reads 0 dB. Frames
+    are handed to the message thread through a lock-free triple buffer.
+
+    BusGovernorAnalysisThread runs every attached analyzer at frameRate on
+    one thread per process (the editor holds it through
+    juce::SharedResourcePointer, so it exists only while an editor is
+    open). Attaching and detaching take its lock; the audio thread never
+    does. Each pass analyses a copy of the client list with the lock
+    released, so attaching never waits for a pass; detaching waits only
+    while a pass that may still use the analyzer runs.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <JuceHeader.h>
+
+//==============================================================================
+class BusGovernorAnalyzerTap
+{
+public:
+    enum Side : int { input, output };
+
+    static constexpr int capacity = 16384;   // per side, power of two
+
+    // Any thread; the analyzer picks it up on its next frame
+    void prepare (double newSampleRate) noexcept     { sampleRate.store (newSampleRate, std::memory_order_relaxed); }
+    double getSampleRate() const noexcept            { return sampleRate.load (std::memory_order_relaxed); }
+
+    void setActive (bool shouldBeActive) noexcept    { active.store (shouldBeActive, std::memory_order_relaxed); }
+    bool isActive() const noexcept                   { return active.load (std::memory_order_relaxed); }
+
+    // Audio thread (or whichever thread runs the block; never two at once).
+    // Drops the block if the reader has fallen that far behind.
+    template <typename SampleType>
+    void push (Side side, const SampleType* const* channels, int numChannels, int numSamples) noexcept
+    {
+        if (! isActive() || numChannels <= 0)
+            return;
+
+        auto& ring = rings[side];
+        const auto pos = ring.writePos.load (std::memory_order_relaxed);
+
+        if (numSamples <= 0 || (std::uint64_t) numSamples > capacity - (pos - ring.readPos.load (std::memory_order_acquire)))
+            return;
+
+        const int start = (int) (pos & (capacity - 1));
+        const int first = std::min (numSamples, capacity - start);
+        const float scale = 1.0f / (float) numChannels;
+
+        mixDown (ring.samples.data() + start, channels, numChannels, 0, first, scale);
+        mixDown (ring.samples.data(), channels, numChannels, first, numSamples - first, scale);
+
+        ring.writePos.store (pos + (std::uint64_t) numSamples, std::memory_order_release);
+    }
+
+    // Analysis thread: copies up to maxSamples of the oldest unread samples
+    // of a side into dest and returns how many were copied
+    int pop (Side side, float* dest, int maxSamples) noexcept
+    {
+        auto& ring = rings[side];
+        const auto pos = ring.readPos.load (std::memory_order_relaxed);
+        const int n = (int) std::min<std::uint64_t> ((std::uint64_t) maxSamples, ring.writePos.load (std::memory_order_acquire) - pos);
+
+        const int start = (int) (pos & (capacity - 1));
+        const int first = std::min (n, capacity - start);
+
+        std::copy_n (ring.samples.data() + start, first, dest);
+        std::copy_n (ring.samples.data(), n - first, dest + first);
+
+        ring.readPos.store (pos + (std::uint64_t) n, std::memory_order_release);
+        return n;
+    }
+
+private:
+    // Channel-outer, so both loops vectorise
+    template <typename SampleType>
+    static void mixDown (float* dest, const SampleType* const* channels, int numChannels, int offset, int n, float scale) noexcept
+    {
+        const auto* x = channels[0] + offset;
+
+        for (int i = 0; i < n; ++i)
+            dest[i] = scale * (float) x[i];
+
+        for (int ch = 1; ch < numChannels; ++ch)
+        {
+            x = channels[ch] + offset;
+
+            for (int i = 0; i < n; ++i)
+                dest[i] += scale * (float) x[i];
+        }
+    }
+
+    // Single-producer/single-consumer ring; positions only ever grow
+    struct Ring
+    {
+        std::array<float, capacity> samples {};
+        alignas (64) std::atomic<std::uint64_t> writePos { 0 };
+        alignas (64) std::atomic<std::uint64_t> readPos { 0 };
+    };
+
+    std::array<Ring, 2> rings;
+    std::atomic<double> sampleRate { 44100.0 };
+    std::atomic<bool> active { false };
+};
+
+//==============================================================================
+class BusGovernorSpectrumAnalyzer
+{
+public:
+    static constexpr int fftOrder = 12;
+    static constexpr int fftSize = 1 << fftOrder;   // 85 ms at 48 kHz
+    static constexpr int numPoints = 160;
+
+    static constexpr float minFrequency = 20.0f, maxFrequency = 20000.0f;
+    static constexpr float floorDb = -120.0f;
+
+    struct Frame
+    {
+        // Level in dB at point k, frequency minFrequency * (maxFrequency / minFrequency)^(k / (numPoints - 1))
+        std::array<float, numPoints> input, output;
+    };
+
+    explicit BusGovernorSpectrumAnalyzer (BusGovernorAnalyzerTap& tapToRead)
+        : tap (tapToRead), inputHistory ((size_t) fftSize), outputHistory ((size_t) fftSize),
+          scratch ((size_t) fftSize), window ((size_t) fftSize), windowed ((size_t) fftSize), bins ((size_t) fftSize)
+    {
+        juce::dsp::WindowingFunction<float>::fillWindowingTables (window.data(), (size_t) fftSize,
+                                                                  juce::dsp::WindowingFunction<float>::hann, false);
+
+        for (auto& f : frames)
+        {
+            f.input.fill (floorDb);
+            f.output.fill (floorDb);
+        }
+
+        smoothed = frames[0];
+        tap.setActive (true);
+    }
+
+    ~BusGovernorSpectrumAnalyzer()
+    {
+        tap.setActive (false);
+    }
+
+    //==============================================================================
+    // Analysis thread: one frame from the latest samples (nothing if the host
+    // has not processed anything since the last one)
+    void analyse() noexcept
+    {
+        const double sampleRate = tap.getSampleRate();
+
+        if (sampleRate != pointsSampleRate)
+            mapPoints (sampleRate);
+
+        const bool newInput  = drain (BusGovernorAnalyzerTap::input,  inputHistory,  inputPos);
+        const bool newOutput = drain (BusGovernorAnalyzerTap::output, outputHistory, outputPos);
+
+        if (! (newInput || newOutput))
+            return;
+
+        // Two real transforms for the price of one: x = in + j out
+        for (int i = 0; i < fftSize; ++i)
+        {
+            const auto w = window[(size_t) i];
+            windowed[(size_t) i] = { inputHistory[(size_t) ((inputPos + i) & (fftSize - 1))] * w,
+                                     outputHistory[(size_t) ((outputPos + i) & (fftSize - 1))] * w };
+        }
+
+        fft.perform (windowed.data(), bins.data(), false);
+
+        auto& frame = frames[(size_t) back];
+
+        for (int k = 0; k < numPoints; ++k)
+        {
+            const auto& p = points[(size_t) k];
+            float inPower, outPower;
+
+            if (p.last >= p.first)
+            {
+                inPower = outPower = 0.0f;
+
+                for (int b = p.first; b <= p.last; ++b)
+                {
+                    inPower  = std::max (inPower,  sidePower (b, false));
+                    outPower = std::max (outPower, sidePower (b, true));
+                }
+            }
+            else
+            {
+                // Narrower than a bin (low end): interpolate between the two
+                inPower  = sidePower (p.last, false) + p.frac * (sidePower (p.first, false) - sidePower (p.last, false));
+                outPower = sidePower (p.last, true)  + p.frac * (sidePower (p.first, true)  - sidePower (p.last, true));
+            }
+
+            frame.input[(size_t) k]  = smoothed.input[(size_t) k]  = ballistics (smoothed.input[(size_t) k],  toDb (inPower));
+            frame.output[(size_t) k] = smoothed.output[(size_t) k] = ballistics (smoothed.output[(size_t) k], toDb (outPower));
+        }
+
+        back = latest.exchange (back | freshBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    // Message thread: the newest frame if one arrived since the last call,
+    // else nullptr. Valid until the next call.
+    const Frame* fetchNewFrame() noexcept
+    {
+        if ((latest.load (std::memory_order_relaxed) & freshBit) == 0)
+            return nullptr;
+
+        front = latest.exchange (front, std::memory_order_acq_rel) & indexMask;
+        return &frames[(size_t) front];
+    }
+
+    static float pointFrequency (int k) noexcept
+    {
+        return minFrequency * std::pow (maxFrequency / minFrequency, (float) k / (float) (numPoints - 1));
+    }
+
+private:
+    //==============================================================================
+    // Bins [first, last] lie within the point's band (halfway, on a log
+    // scale, to its neighbours); if none do, last + frac between last and
+    // first = last + 1 is the point's own frequency
+    struct Point
+    {
+        int first = 1, last = 0;
+        float frac = 0.0f;
+    };
+
+    void mapPoints (double sampleRate) noexcept
+    {
+        pointsSampleRate = sampleRate;
+
+        const double binHz = sampleRate / fftSize;
+        const double halfStep = std::sqrt (std::pow ((double) maxFrequency / minFrequency, 1.0 / (numPoints - 1)));
+
+        for (int k = 0; k < numPoints; ++k)
+        {
+            const double f = pointFrequency (k);
+            const double bin = std::clamp (f / binHz, 1.0, fftSize / 2 - 1.0);   // never the DC bin
+            auto& p = points[(size_t) k];
+
+            p.first = std::max (1, (int) std::ceil (f / halfStep / binHz));
+            p.last  = std::min (fftSize / 2, (int) std::floor (f * halfStep / binHz));
+
+            if (p.last < p.first)
+            {
+                p.last  = (int) bin;
+                p.first = p.last + 1;
+                p.frac  = (float) (bin - p.last);
+            }
+        }
+    }
+
+    // Appends everything the tap has for one side to its history, a ring of
+    // the last fftSize samples whose oldest sits at pos
+    bool drain (BusGovernorAnalyzerTap::Side side, std::vector<float>& history, int& pos) noexcept
+    {
+        bool any = false;
+
+        for (int n; (n = tap.pop (side, scratch.data(), fftSize)) > 0;)
+        {
+            any = true;
+
+            for (int i = 0; i < n; ++i)
+            {
+                history[(size_t) pos] = scratch[(size_t) i];
+                pos = (pos + 1) & (fftSize - 1);
+            }
+        }
+
+        return any;
+    }
+
+    // Power of one side at bin b: in = (X[b] + conj X[N - b]) / 2,
+    // out = (X[b] - conj X[N - b]) / 2j
+    float sidePower (int b, bool outputSide) const noexcept
+    {
+        const auto x = bins[(size_t) b];
+        const auto y = std::conj (bins[(size_t) ((fftSize - b) & (fftSize - 1))]);
+
+        return std::norm (outputSide ? x - y : x + y) * 0.25f;
+    }
+
+    // Hann coherent gain 0.5: a full-scale sine peaks at fftSize / 4
+    static float toDb (float power) noexcept
+    {
+        constexpr float norm = 16.0f / ((float) fftSize * (float) fftSize);
+        return std::max (floorDb, 10.0f * std::log10 (power * norm + 1.0e-30f));
+    }
+
+    static float ballistics (float current, float target) noexcept
+    {
+        return current + (target > current ? 0.7f : 0.25f) * (target - current);
+    }
+
+    //==============================================================================
+    BusGovernorAnalyzerTap& tap;
+
+    std::vector<float> inputHistory, outputHistory, scratch, window;
+    int inputPos = 0, outputPos = 0;
+
+    juce::dsp::FFT fft { fftOrder };
+    std::vector<juce::dsp::Complex<float>> windowed, bins;
+
+    std::array<Point, numPoints> points;
+    double pointsSampleRate = 0.0;
+
+    // Triple buffer: the analysis thread fills `back`, the message thread
+    // reads `front`, `latest` holds the third and whether it is unread
+    static constexpr int indexMask = 3, freshBit = 4;
+
+    Frame smoothed;
+    std::array<Frame, 3> frames;
+    int back = 0, front = 1;
+    std::atomic<int> latest { 2 };
+};
+
+//==============================================================================
+class BusGovernorAnalysisThread
+{
+public:
+    static constexpr int frameRate = 30;
+
+    BusGovernorAnalysisThread()
+        : thread ([this] { run(); })
+    {
+    }
+
+    ~BusGovernorAnalysisThread()
+    {
+        {
+            const std::lock_guard<std::mutex> lock (clientLock);
+            stopping = true;
+        }
+
+        wake.notify_all();
+        thread.join();
+    }
+
+    // Message thread. Once remove() returns the analyzer is not in use.
+    void add (BusGovernorSpectrumAnalyzer& analyzer)
+    {
+        const std::lock_guard<std::mutex> lock (clientLock);
+        clients.push_back (&analyzer);
+    }
+
+    void remove (BusGovernorSpectrumAnalyzer& analyzer)
+    {
+        std::unique_lock<std::mutex> lock (clientLock);
+        clients.erase (std::remove (clients.begin(), clients.end(), &analyzer), clients.end());
+
+        // A pass that started before the erase may still hold it; later
+        // ones copy the list without it
+        const auto pass = passesDone;
+        passDone.wait (lock, [this, pass] { return ! analysing || passesDone != pass; });
+    }
+
+private:
+    void run()
+    {
+        const auto interval = std::chrono::microseconds (1000000 / frameRate);
+        auto next = std::chrono::steady_clock::now();
+
+        std::unique_lock<std::mutex> lock (clientLock);
+
+        while (! stopping)
+        {
+            // Reuses its capacity: allocates only when the list has grown
+            passClients = clients;
+            analysing = true;
+            lock.unlock();
+
+            for (auto* c : passClients)
+                c->analyse();
+
+            lock.lock();
+            analysing = false;
+            ++passesDone;
+            passDone.notify_all();
+
+            next = std::max (next + interval, std::chrono::steady_clock::now());
+            wake.wait_until (lock, next, [this] { return stopping; });
+        }
+    }
+
+    std::mutex clientLock;
+    std::condition_variable wake, passDone;
+    std::vector<BusGovernorSpectrumAnalyzer*> clients;
+    bool stopping = false;
+
+    // The pass in progress, and how many have finished (under clientLock)
+    std::vector<BusGovernorSpectrumAnalyzer*> passClients;
+    bool analysing = false;
+    std::uint64_t passesDone = 0;
+
+    std::thread thread;   // last: starts once everything above exists
+};
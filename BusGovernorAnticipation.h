@@ -0,0 +1,481 @@
+/*
+  ==============================================================================
+
+    BusGovernorAnticipation - processing one block ahead on shared workers.
+
+    Hosts call every instance's processBlock on a few audio threads, so a
+    dense session can run out of time on those threads while other cores
+    sit idle. An anticipating instance hands each block to a worker and
+    returns the block before it, which a worker finished in the meantime.
+    The host thread only copies audio in and out, and the instance reports
+    one more prepared block of latency.
+
+    BusGovernorWorkerPool is the shared part: cores - 1 threads draining a
+    bounded lock-free MPMC queue (one per process; the plugin creates it
+    through juce::SharedResourcePointer the first time an instance turns
+    anticipation on). Idle workers yield for a while, then sleep on a
+    condition variable with no timeout, so an idle pool never wakes up.
+    Submitting never blocks: a queue push and, if a worker sleeps, an
+    unlocked notify. A wakeup lost to that unlocked notify costs at most a
+    fallback (below): the next submit notifies again, and release() wakes
+    the pool itself before it waits for the instance's queue entries.
+
+    BusGovernorAnticipatorT is the per-instance part. Each call:
+
+      1. finishes the block in flight: if a worker is done, take it; if no
+         worker has started it yet, claim it and process it inline (the
+         fallback when the pool misses the deadline); if a worker is on it,
+         wait, which costs at most that block's own processing time
+      2. appends it to an output FIFO holding exactly the latency, and
+         hands back the oldest samples
+      3. copies this call's input and submits it
+
+    The host thread and the worker meet on one atomic state word per
+    instance, with the audio in the instance's own buffers, so no lock is
+    taken on either side. Blocks longer than the latency are split, and
+    every sample still sees the same delay.
+
+    reset() only touches the instance's own block: a queued one is claimed
+    back and dropped, a running one costs the same wait as in step 1.
+    Entries a claimed block left in the queue find nothing to do when a
+    worker pops them. Only release(), before the instance goes away, waits
+    for those entries to leave the queue; it blocks, so never call it on
+    the audio thread.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//==============================================================================
+class BusGovernorWorkerPool
+{
+public:
+    struct Task
+    {
+        virtual ~Task() = default;
+        virtual void run() noexcept = 0;
+
+        // Queue entries still pointing at this task (a task may be queued
+        // again before a worker pops its older entry); owners must see 0
+        // before the task goes away
+        std::atomic<int> queuedRefs { 0 };
+    };
+
+    //==============================================================================
+    explicit BusGovernorWorkerPool (int numWorkers = getDefaultNumWorkers())
+        : cells (new Cell[queueCapacity])
+    {
+        for (size_t i = 0; i < queueCapacity; ++i)
+            cells[i].sequence.store (i, std::memory_order_relaxed);
+
+        for (int i = 0; i < std::max (1, numWorkers); ++i)
+            workers.emplace_back ([this] { workerLoop(); });
+    }
+
+    ~BusGovernorWorkerPool()
+    {
+        {
+            const std::lock_guard<std::mutex> lock (sleepLock);
+            stopping.store (true, std::memory_order_relaxed);
+        }
+
+        wake.notify_all();
+
+        for (auto& t : workers)
+            t.join();
+    }
+
+    static int getDefaultNumWorkers() noexcept
+    {
+        return std::max (1, (int) std::thread::hardware_concurrency() - 1);
+    }
+
+    int getNumWorkers() const noexcept      { return (int) workers.size(); }
+
+    // Any thread; never blocks. False if the queue is full.
+    bool submit (Task& task) noexcept
+    {
+        task.queuedRefs.fetch_add (1, std::memory_order_relaxed);
+
+        if (! push (&task))
+        {
+            task.queuedRefs.fetch_sub (1, std::memory_order_relaxed);
+            return false;
+        }
+
+        // Pairs with the sleeper's seq_cst increment and queue check
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+
+        if (sleeping.load (std::memory_order_relaxed) > 0)
+            wake.notify_one();
+
+        return true;
+    }
+
+    // Not real-time safe (locks and blocks): returns once no queue entry
+    // points at task. Wakes every worker first, so an entry stuck behind a
+    // lost wakeup gets popped all the same.
+    void waitUntilDequeued (Task& task)
+    {
+        std::unique_lock<std::mutex> lock (sleepLock);
+        dequeueWaiters.fetch_add (1, std::memory_order_seq_cst);
+
+        wake.notify_all();
+        dequeued.wait (lock, [&task] { return task.queuedRefs.load (std::memory_order_seq_cst) == 0; });
+
+        dequeueWaiters.fetch_sub (1, std::memory_order_relaxed);
+    }
+
+private:
+    //==============================================================================
+    // Bounded MPMC ring (Vyukov): each cell's sequence number says whether
+    // it is free for the producer or full for the consumer at a position
+    static constexpr size_t queueCapacity = 4096;   // power of two
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence { 0 };
+        Task* task = nullptr;
+    };
+
+    bool push (Task* task) noexcept
+    {
+        auto pos = tail.load (std::memory_order_relaxed);
+
+        for (;;)
+        {
+            auto& cell = cells[pos & (queueCapacity - 1)];
+            const auto diff = (std::ptrdiff_t) cell.sequence.load (std::memory_order_acquire) - (std::ptrdiff_t) pos;
+
+            if (diff == 0)
+            {
+                if (tail.compare_exchange_weak (pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.task = task;
+                    cell.sequence.store (pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = tail.load (std::memory_order_relaxed);
+            }
+        }
+    }
+
+    Task* pop() noexcept
+    {
+        auto pos = head.load (std::memory_order_relaxed);
+
+        for (;;)
+        {
+            auto& cell = cells[pos & (queueCapacity - 1)];
+            const auto diff = (std::ptrdiff_t) cell.sequence.load (std::memory_order_acquire) - (std::ptrdiff_t) (pos + 1);
+
+            if (diff == 0)
+            {
+                if (head.compare_exchange_weak (pos, pos + 1, std::memory_order_relaxed))
+                {
+                    auto* task = cell.task;
+                    cell.sequence.store (pos + queueCapacity, std::memory_order_release);
+                    return task;
+                }
+            }
+            else if (diff < 0)
+            {
+                return nullptr;
+            }
+            else
+            {
+                pos = head.load (std::memory_order_relaxed);
+            }
+        }
+    }
+
+    //==============================================================================
+    bool runOne() noexcept
+    {
+        auto* task = pop();
+
+        if (task == nullptr)
+            return false;
+
+        task->run();
+
+        // Pairs with the waiter's seq_cst increment and check; the task
+        // may be gone once the count reads 0
+        task->queuedRefs.fetch_sub (1, std::memory_order_seq_cst);
+
+        if (dequeueWaiters.load (std::memory_order_seq_cst) > 0)
+        {
+            const std::lock_guard<std::mutex> lock (sleepLock);
+            dequeued.notify_all();
+        }
+
+        return true;
+    }
+
+    void workerLoop()
+    {
+        int idleSpins = 0;
+
+        while (! stopping.load (std::memory_order_relaxed))
+        {
+            if (runOne())
+            {
+                idleSpins = 0;
+                continue;
+            }
+
+            // While blocks are flowing the next one is usually a few
+            // microseconds away; yield for a while before sleeping
+            if (++idleSpins < maxIdleSpins)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock (sleepLock);
+            sleeping.fetch_add (1, std::memory_order_seq_cst);
+
+            if (head.load (std::memory_order_seq_cst) == tail.load (std::memory_order_seq_cst) && ! stopping.load())
+                wake.wait (lock);
+
+            sleeping.fetch_sub (1, std::memory_order_relaxed);
+            idleSpins = 0;
+        }
+    }
+
+    static constexpr int maxIdleSpins = 2000;
+
+    std::unique_ptr<Cell[]> cells;
+    alignas (64) std::atomic<size_t> head { 0 };
+    alignas (64) std::atomic<size_t> tail { 0 };
+
+    std::mutex sleepLock;
+    std::condition_variable wake, dequeued;
+    std::atomic<int> sleeping { 0 }, dequeueWaiters { 0 };
+    std::atomic<bool> stopping { false };
+
+    std::vector<std::thread> workers;
+};
+
+//==============================================================================
+template <typename SampleType>
+class BusGovernorAnticipatorT  : private BusGovernorWorkerPool::Task
+{
+public:
+    // Processes channels[0 .. numChannels - 1] in place, on whichever thread
+    // runs the block (never two at once, and always in order)
+    using BlockProcessor = std::function<void (SampleType* const* channels, int numChannels, int numSamples)>;
+
+    struct Stats
+    {
+        std::uint64_t blocks    = 0;   // blocks submitted
+        std::uint64_t fallbacks = 0;   // no worker had started: processed inline
+        std::uint64_t waits     = 0;   // a worker was still on it: host thread waited
+    };
+
+    ~BusGovernorAnticipatorT() override
+    {
+        release();
+    }
+
+    //==============================================================================
+    // Allocates; not real-time safe. Latency is one block of maxBlockSize.
+    void prepare (int newNumChannels, int maxBlockSize, BlockProcessor newProcessor)
+    {
+        release();
+
+        numChannels = std::max (0, newNumChannels);
+        latency = std::max (1, maxBlockSize);
+        processor = std::move (newProcessor);
+
+        fifo.assign ((size_t) numChannels, std::vector<SampleType> ((size_t) latency, SampleType (0)));
+        job.assign ((size_t) numChannels, std::vector<SampleType> ((size_t) latency, SampleType (0)));
+
+        jobPointers.clear();
+
+        for (auto& ch : job)
+            jobPointers.push_back (ch.data());
+
+        reset();
+    }
+
+    // Host thread: drops the block in flight and the FIFO; the next
+    // getLatency() output samples are silence. Real-time safe.
+    void reset() noexcept
+    {
+        int expected = queued;
+
+        if (! state.compare_exchange_strong (expected, idle, std::memory_order_acquire))
+        {
+            waitForWorker();
+            state.store (idle, std::memory_order_relaxed);
+        }
+
+        for (auto& ch : fifo)
+            std::fill (ch.begin(), ch.end(), SampleType (0));
+
+        fifoPos = 0;
+    }
+
+    // Not the audio thread (blocks): no block in flight and no queue entry
+    // left pointing here once this returns
+    void release()
+    {
+        reset();
+
+        if (pool != nullptr)
+            pool->waitUntilDequeued (*this);
+    }
+
+    // Host thread: completes the block in flight now rather than at the next
+    // process(), so the caller can change what the processor reads while
+    // no worker is running it
+    void finish() noexcept                  { finishBlockInFlight(); }
+
+    int getLatency() const noexcept         { return latency; }
+    int getNumChannels() const noexcept     { return numChannels; }
+
+    // Any thread
+    Stats getStats() const noexcept
+    {
+        return { blocks.load (std::memory_order_relaxed),
+                 fallbacks.load (std::memory_order_relaxed),
+                 waits.load (std::memory_order_relaxed) };
+    }
+
+    //==============================================================================
+    // Host thread. io[0 .. getNumChannels() - 1] come back delayed by
+    // getLatency() samples.
+    void process (BusGovernorWorkerPool& workerPool, SampleType* const* io, int numSamples) noexcept
+    {
+        pool = &workerPool;
+
+        for (int start = 0; start < numSamples; start += latency)
+        {
+            const int n = std::min (latency, numSamples - start);
+
+            finishBlockInFlight();
+
+            // The FIFO holds exactly `latency` samples here: swap the
+            // oldest n out for this call's input, which becomes the job
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto* x = io[ch] + start;
+                auto* j = job[(size_t) ch].data();
+                auto* f = fifo[(size_t) ch].data();
+
+                std::copy (x, x + n, j);
+
+                const int first = std::min (n, latency - fifoPos);
+                std::copy (f + fifoPos, f + fifoPos + first, x);
+                std::copy (f, f + (n - first), x + first);
+            }
+
+            jobSamples = n;
+            bump (blocks);
+
+            state.store (queued, std::memory_order_release);
+
+            if (! pool->submit (*this))
+                finishBlockInFlight();   // queue full: do it now
+        }
+    }
+
+private:
+    //==============================================================================
+    enum : int { idle, queued, running, done };
+
+    // Worker thread: a stale queue entry finds the state already moved on
+    void run() noexcept override
+    {
+        int expected = queued;
+
+        if (! state.compare_exchange_strong (expected, running, std::memory_order_acquire))
+            return;
+
+        processor (jobPointers.data(), numChannels, jobSamples);
+        state.store (done, std::memory_order_release);
+    }
+
+    // Host thread: completes the submitted block (inline if no worker took
+    // it) and writes it into the FIFO where the outgoing samples were
+    void finishBlockInFlight() noexcept
+    {
+        auto s = state.load (std::memory_order_acquire);
+
+        if (s == idle)
+            return;
+
+        if (s == queued && state.compare_exchange_strong (s, running, std::memory_order_acquire))
+        {
+            processor (jobPointers.data(), numChannels, jobSamples);
+            bump (fallbacks);
+        }
+        else if (state.load (std::memory_order_acquire) != done)
+        {
+            bump (waits);
+            waitForWorker();
+        }
+
+        const int n = jobSamples;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto* j = job[(size_t) ch].data();
+            auto* f = fifo[(size_t) ch].data();
+
+            const int first = std::min (n, latency - fifoPos);
+            std::copy (j, j + first, f + fifoPos);
+            std::copy (j + first, j + n, f);
+        }
+
+        fifoPos = (fifoPos + n) % latency;
+        state.store (idle, std::memory_order_relaxed);
+    }
+
+    // A worker is on the block: at most that block's processing time
+    void waitForWorker() const noexcept
+    {
+        while (state.load (std::memory_order_acquire) == running)
+            std::this_thread::yield();
+    }
+
+    static void bump (std::atomic<std::uint64_t>& c) noexcept   { c.store (c.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+
+    //==============================================================================
+    int numChannels = 0, latency = 1;
+    BlockProcessor processor;
+
+    // Output FIFO: a ring of exactly `latency` samples per channel; the
+    // oldest sample sits at fifoPos and is the next one out
+    std::vector<std::vector<SampleType>> fifo;
+    int fifoPos = 0;
+
+    // The block in flight, processed in place
+    std::vector<std::vector<SampleType>> job;
+    std::vector<SampleType*> jobPointers;
+    int jobSamples = 0;
+
+    std::atomic<int> state { idle };
+    BusGovernorWorkerPool* pool = nullptr;   // the last process() call's, for release()
+    std::atomic<std::uint64_t> blocks { 0 }, fallbacks { 0 }, waits { 0 };
+};
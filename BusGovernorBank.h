@@ -0,0 +1,398 @@
+/*
+  ==============================================================================
+
+    BusGovernorBank - many independent stereo governors processed in lanes.
+
+    A single bus's a/b recurrence is serially dependent, so it cannot be
+    vectorized on its own. A bank lines N buses up in structure-of-arrays
+    lanes (blocks of 16) and advances all of them one sample at a time, so the
+    per-sample recurrence runs in SIMD registers across buses. A block with
+    at most 4 or 8 active lanes runs only those, in narrower registers.
+
+    The recurrence kernel is compiled for SSE2, AVX2+FMA and AVX-512
+    (F, DQ, VL) and the widest one the CPU supports is picked at construction
+    (GCC/Clang on x86; other compilers get the baseline build only).
+    Tools/BusGovernorBench's "bank" and "scalar" cases (/busesN) measure the
+    per-bus cost against one BusGovernorCore per bus.
+
+    Lanes need not be separate buses: BusGovernorMultiband runs the bands of
+    one bus as lanes.
+
+    setLaneTargetParameters() ramps a lane's drive, pressure and volume per
+    sample across the next process() call, as the core does (or across a
+    span of several calls, for callers that process a block in pieces);
+    the drive ramp is one more vector add in the recurrence.
+
+    Vectorizing needs a branch-free pow, so the bank defaults to
+    BusGovernorFastPow (see BusGovernorMath.h for its error bound). With
+    BusGovernorStdPow, or with double lanes (whose pow is always std::pow),
+    the math is the same as BusGovernorCore but the lanes run scalar. The
+    AVX2/AVX-512 builds may contract to FMA, so outputs can differ from a
+    scalar instance in the last few ulps.
+
+    The lane loops rely on the auto-vectorizer, so build with -O3 (the
+    Projucer release default); GCC's -O2 cost model leaves them scalar.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "BusGovernorCore.h"
+
+#include <array>
+#include <type_traits>
+#include <vector>
+
+#if (defined (__GNUC__) || defined (__clang__)) && (defined (__x86_64__) || defined (__i386__))
+ #define BUSGOVERNOR_BANK_DISPATCH 1
+ #define BUSGOVERNOR_TARGET(isa) __attribute__ ((target (isa)))
+ #define BUSGOVERNOR_FORCE_INLINE inline __attribute__ ((always_inline))
+#else
+ #define BUSGOVERNOR_BANK_DISPATCH 0
+ #define BUSGOVERNOR_FORCE_INLINE inline
+#endif
+
+//==============================================================================
+template <typename PowEngine = BusGovernorFastPow, typename SampleType = float>
+class BusGovernorBankT
+{
+public:
+    using Core       = BusGovernorCoreT<PowEngine, SampleType>;
+    using State      = typename Core::State;
+    using Parameters = typename Core::Parameters;
+
+    static constexpr int laneBlock  = 16;   // one AVX-512 register of floats, two of doubles
+    static constexpr int chunkSize  = 64;   // samples per detector/gain pass
+
+    // Only the fast float pow vectorizes. Otherwise the lanes run scalar, so
+    // the recurrence skips the padding lanes of a partly used block.
+    static constexpr bool vectorLanes = std::is_same<PowEngine, BusGovernorFastPow>::value
+                                     && std::is_same<SampleType, float>::value;
+
+    //==============================================================================
+    BusGovernorBankT()
+    {
+        pickKernels();
+    }
+
+    // Allocates lane storage. Not real-time safe; call before processing.
+    void prepare (int newNumLanes)
+    {
+        numLanes = newNumLanes;
+
+        const auto padded = (size_t) ((numLanes + laneBlock - 1) / laneBlock * laneBlock);
+
+        a.assign (padded, SampleType (1));
+        b.assign (padded, SampleType (1));
+        drive.assign (padded, (SampleType) Parameters().drive);
+        driveStep.assign (padded, SampleType (0));
+        params.assign ((size_t) numLanes, Parameters());
+        targets.assign ((size_t) numLanes, Parameters());
+
+        det.assign ((size_t) (chunkSize * laneBlock), SampleType (0));
+        invb.assign ((size_t) (chunkSize * laneBlock), SampleType (1));
+
+        setNumActiveLanes (numLanes);
+    }
+
+    void reset() noexcept
+    {
+        std::fill (a.begin(), a.end(), SampleType (1));
+        std::fill (b.begin(), b.end(), SampleType (1));
+    }
+
+    int getNumLanes() const noexcept                    { return numLanes; }
+
+    // process() runs the first count lanes (at most the prepared number);
+    // the others keep their state until they are active again
+    void setNumActiveLanes (int count) noexcept
+    {
+        activeLanes = std::min (std::max (0, count), numLanes);
+        numBlocks = (activeLanes + laneBlock - 1) / laneBlock;
+    }
+
+    int getNumActiveLanes() const noexcept              { return activeLanes; }
+
+    void setLaneParameters (int lane, const Parameters& p) noexcept
+    {
+        params[(size_t) lane]  = targets[(size_t) lane] = p;
+        drive[(size_t) lane]   = (SampleType) p.drive;
+    }
+
+    // Ramps the lane linearly from its current parameters to p across the
+    // next process() call, like BusGovernorCore::setTargetParameters
+    void setLaneTargetParameters (int lane, const Parameters& p) noexcept
+    {
+        targets[(size_t) lane] = p;
+    }
+
+    State getLaneState (int lane) const noexcept
+    {
+        return { a[(size_t) lane], b[(size_t) lane] };
+    }
+
+    //==============================================================================
+    // left[i] / right[i] are lane i's channels, processed in place. right[i]
+    // may be nullptr for a mono lane (the detector then sees l + l).
+    void process (SampleType* const* left, SampleType* const* right, int numSamples) noexcept
+    {
+        process (left, right, numSamples, 0, numSamples);
+    }
+
+    // One piece of a longer block, for callers that process a block in
+    // passes: the ramps span rampLength samples and this call covers
+    // [offset, offset + numSamples) of them. The lanes reach their targets
+    // with the piece that ends the span; the pieces must come in order.
+    void process (SampleType* const* left, SampleType* const* right, int numSamples,
+                  int offset, int rampLength) noexcept
+    {
+        const bool ramping = startRamps (offset, rampLength);
+
+        for (int start = 0; start < numSamples; start += chunkSize)
+        {
+            const int n = std::min (chunkSize, numSamples - start);
+
+            for (int blk = 0; blk < numBlocks; ++blk)
+            {
+                const int firstLane = blk * laneBlock;
+                const int lanesHere = std::min (laneBlock, activeLanes - firstLane);
+
+                // ---- Detector, transposed to [sample][lane] ----
+                for (int i = 0; i < lanesHere; ++i)
+                {
+                    const SampleType* l = left[firstLane + i] + start;
+                    const SampleType* r = (right[firstLane + i] != nullptr) ? right[firstLane + i] + start : l;
+
+                    for (int s = 0; s < n; ++s)
+                        det[(size_t) (s * laneBlock + i)] = std::abs (l[s] + r[s]);
+                }
+
+                for (int i = lanesHere; i < laneBlock; ++i)
+                    for (int s = 0; s < n; ++s)
+                        det[(size_t) (s * laneBlock + i)] = SampleType (0);
+
+                // ---- Recurrence across lanes ----
+                recurrence[widthIndex (lanesHere)] (a.data() + firstLane, b.data() + firstLane, drive.data() + firstLane,
+                                                    driveStep.data() + firstLane, det.data(), invb.data(), n, lanesHere);
+
+                // ---- Shaper + volume per lane ----
+                for (int i = 0; i < lanesHere; ++i)
+                {
+                    const auto& p = params[(size_t) (firstLane + i)];
+
+                    const auto pressure = (SampleType) p.pressure;
+                    const auto volume   = (SampleType) p.volume;
+
+                    SampleType* l = left[firstLane + i] + start;
+                    SampleType* r = right[firstLane + i] != nullptr ? right[firstLane + i] + start : nullptr;
+
+                    // The lane's gains, contiguous so the shaper vectorizes
+                    SampleType g[chunkSize];
+
+                    for (int s = 0; s < n; ++s)
+                        g[s] = invb[(size_t) (s * laneBlock + i)];
+
+                    if (ramping)
+                    {
+                        const auto& t = targets[(size_t) (firstLane + i)];
+                        applyRamped (l, r, g, n, offset + start, rampLength, pressure, (SampleType) t.pressure, volume, (SampleType) t.volume);
+                        continue;
+                    }
+
+                    for (int s = 0; s < n; ++s)
+                        l[s] = Core::shape (l[s], g[s], pressure) * volume;
+
+                    if (r != nullptr)
+                        for (int s = 0; s < n; ++s)
+                            r[s] = Core::shape (r[s], g[s], pressure) * volume;
+                }
+            }
+        }
+
+        if (ramping && offset + numSamples >= rampLength)
+            finishRamps();
+    }
+
+private:
+    //==============================================================================
+    // Per-sample drive steps for the recurrence (sample k of the span gets
+    // k + 1 steps). False, with all steps zero, when no lane is ramping.
+    // Pieces after the first keep the drive where the last one left it.
+    bool startRamps (int offset, int rampLength) noexcept
+    {
+        bool ramping = false;
+
+        for (int i = 0; i < activeLanes; ++i)
+        {
+            const auto& p = params[(size_t) i];
+            const auto& t = targets[(size_t) i];
+
+            ramping = ramping || p.pressure != t.pressure || p.drive != t.drive || p.volume != t.volume;
+        }
+
+        if (! ramping || rampLength <= 0)
+            return false;
+
+        if (offset > 0)
+            return true;
+
+        const SampleType inc = SampleType (1) / (SampleType) rampLength;
+
+        for (int i = 0; i < activeLanes; ++i)
+        {
+            drive[(size_t) i]     = (SampleType) params[(size_t) i].drive;
+            driveStep[(size_t) i] = ((SampleType) targets[(size_t) i].drive - (SampleType) params[(size_t) i].drive) * inc;
+        }
+
+        return true;
+    }
+
+    // The lanes land exactly on their targets
+    void finishRamps() noexcept
+    {
+        for (int i = 0; i < activeLanes; ++i)
+        {
+            params[(size_t) i] = targets[(size_t) i];
+            drive[(size_t) i] = (SampleType) targets[(size_t) i].drive;
+            driveStep[(size_t) i] = SampleType (0);
+        }
+    }
+
+    // Shaper + volume for one lane of a chunk starting at sample start of
+    // the ramp span, pressure and volume ramped from where the span started
+    // to the targets at its last sample
+    static void applyRamped (SampleType* l, SampleType* r, const SampleType* g, int n, int start, int rampLength,
+                             SampleType pressure0, SampleType pressure1, SampleType volume0, SampleType volume1) noexcept
+    {
+        const SampleType inc = SampleType (1) / (SampleType) rampLength;
+        const SampleType dPressure = (pressure1 - pressure0) * inc;
+        const SampleType dVolume   = (volume1 - volume0) * inc;
+
+        for (int s = 0; s < n; ++s)
+        {
+            const auto k = (SampleType) (start + s + 1);
+            const SampleType pressure = pressure0 + dPressure * k;
+            const SampleType volume   = volume0 + dVolume * k;
+
+            l[s] = Core::shape (l[s], g[s], pressure) * volume;
+
+            if (r != nullptr)
+                r[s] = Core::shape (r[s], g[s], pressure) * volume;
+        }
+    }
+
+    using RecurrenceFn = void (*) (SampleType*, SampleType*, SampleType*, const SampleType*, const SampleType*, SampleType*, int, int);
+
+    // One lane block: advance the first width lanes one sample at a time.
+    // Fixed trip count over lanes so the inner loop maps onto whole vector
+    // registers (scalar lanes stop at the last used one instead). Force-
+    // inlined so each ISA wrapper below gets its own codegen.
+    template <int width>
+    static BUSGOVERNOR_FORCE_INLINE void recurrenceBody (SampleType* __restrict aIn, SampleType* __restrict bIn,
+                                                         SampleType* __restrict driveIn,
+                                                         const SampleType* __restrict driveStepIn,
+                                                         const SampleType* __restrict detIn,
+                                                         SampleType* __restrict invbOut, int n, int lanes) noexcept
+    {
+        const int count = vectorLanes ? width : lanes;
+
+        SampleType la[width], lb[width], ld[width], ls[width];
+
+        for (int i = 0; i < width; ++i)
+        {
+            la[i] = aIn[i];
+            lb[i] = bIn[i];
+            ld[i] = driveIn[i];
+            ls[i] = driveStepIn[i];
+        }
+
+        for (int s = 0; s < n; ++s)
+        {
+            const SampleType* d = detIn + s * laneBlock;
+            SampleType* g       = invbOut + s * laneBlock;
+
+            for (int i = 0; i < count; ++i)
+            {
+                ld[i] += ls[i];
+
+                State st { la[i], lb[i] };
+                g[i]  = Core::advance (st, d[i], ld[i]);
+                la[i] = st.a;
+                lb[i] = st.b;
+            }
+        }
+
+        for (int i = 0; i < width; ++i)
+        {
+            aIn[i] = la[i];
+            bIn[i] = lb[i];
+            driveIn[i] = ld[i];
+        }
+    }
+
+    template <int width>
+    static void recurrenceDefault (SampleType* a, SampleType* b, SampleType* dr, const SampleType* ds, const SampleType* d, SampleType* g, int n, int lanes) noexcept
+    {
+        recurrenceBody<width> (a, b, dr, ds, d, g, n, lanes);
+    }
+
+   #if BUSGOVERNOR_BANK_DISPATCH
+    template <int width>
+    BUSGOVERNOR_TARGET ("avx2,fma")
+    static void recurrenceAVX2 (SampleType* a, SampleType* b, SampleType* dr, const SampleType* ds, const SampleType* d, SampleType* g, int n, int lanes) noexcept
+    {
+        recurrenceBody<width> (a, b, dr, ds, d, g, n, lanes);
+    }
+
+    template <int width>
+    BUSGOVERNOR_TARGET ("avx512f,avx512dq,avx512vl,fma")
+    static void recurrenceAVX512 (SampleType* a, SampleType* b, SampleType* dr, const SampleType* ds, const SampleType* d, SampleType* g, int n, int lanes) noexcept
+    {
+        recurrenceBody<width> (a, b, dr, ds, d, g, n, lanes);
+    }
+   #endif
+
+    // A block runs in the narrowest of 4, 8 or 16 lanes that holds its
+    // active lanes. The recurrence is bound by the latency of one sample's
+    // update, and that grows with the register width: 4 lanes (a 4-band
+    // multiband) run in 47-50 ns per sample, 16 in 52-57 (AVX2/AVX-512)
+    // and 88 (SSE2, four registers).
+    static constexpr int widthIndex (int lanes) noexcept    { return lanes <= 4 ? 0 : (lanes <= 8 ? 1 : 2); }
+
+    void pickKernels() noexcept
+    {
+       #if BUSGOVERNOR_BANK_DISPATCH
+        // Every feature the AVX-512 kernel is built with, or it may fault
+        if (__builtin_cpu_supports ("avx512f") && __builtin_cpu_supports ("avx512dq")
+             && __builtin_cpu_supports ("avx512vl") && __builtin_cpu_supports ("fma"))
+        {
+            recurrence = { recurrenceAVX512<4>, recurrenceAVX512<8>, recurrenceAVX512<16> };
+            return;
+        }
+
+        if (__builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("fma"))
+        {
+            recurrence = { recurrenceAVX2<4>, recurrenceAVX2<8>, recurrenceAVX2<16> };
+            return;
+        }
+       #endif
+
+        recurrence = { recurrenceDefault<4>, recurrenceDefault<8>, recurrenceDefault<16> };
+    }
+
+    //==============================================================================
+    std::array<RecurrenceFn, 3> recurrence {};   // by widthIndex
+
+    int numLanes = 0, activeLanes = 0;
+    int numBlocks = 0;   // lane blocks holding active lanes
+
+    // Per-lane state, padded to whole lane blocks
+    std::vector<SampleType> a, b, drive, driveStep;
+    std::vector<Parameters> params, targets;   // current, and where the next call ramps to
+
+    // Per-chunk scratch, [sample][lane]
+    std::vector<SampleType> det, invb;
+};
+
+using BusGovernorBank = BusGovernorBankT<>;
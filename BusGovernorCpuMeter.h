@@ -0,0 +1,239 @@
+/*
+  ==============================================================================
+
+    BusGovernorCpuMeter - per-block timing on one thread at a time.
+
+    The processor keeps two: one around processBlock on the host thread,
+    one around processSamples, which in anticipative mode runs on a pool
+    worker instead.
+
+    Each block's wall time goes into a fixed log-bucket histogram: 8 buckets
+    per octave from 64 ns up to about 4.3 s, so any percentile is known to
+    within 12.5%. The timed thread is the only writer and every counter is a
+    relaxed atomic, so recording is wait-free: two clock reads and a handful
+    of stores, about 100 ns per block (0.2 ns per frame at 512 samples).
+    Any other thread may call getStats() at any time; it sees counters that
+    are at most one block apart from each other.
+
+    The real-time budget of a block is numSamples / sampleRate. A block that
+    takes longer than its budget counts as an overrun.
+
+    Define BUSGOVERNOR_CPU_METER=0 to compile all of it out: the class keeps
+    its interface but record() and ScopedTimer are empty and getStats()
+    returns zeros.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#ifndef BUSGOVERNOR_CPU_METER
+ #define BUSGOVERNOR_CPU_METER 1
+#endif
+
+//==============================================================================
+class BusGovernorCpuMeter
+{
+public:
+    static constexpr bool enabled = BUSGOVERNOR_CPU_METER != 0;
+
+    struct Stats
+    {
+        std::uint64_t blocks   = 0;
+        std::uint64_t overruns = 0;     // blocks slower than their own budget
+
+        double meanNs = 0.0;
+        double p99Ns  = 0.0;            // upper edge of the bucket, capped at maxNs
+        double maxNs  = 0.0;
+
+        double budgetNs = 0.0;          // one block of the prepared size
+        double load     = 0.0;          // total time / total audio time
+        double p99Load  = 0.0;          // p99Ns / budgetNs
+        double maxLoad  = 0.0;          // maxNs / budgetNs
+    };
+
+    //==============================================================================
+    // Not real-time safe with respect to record(); call while the audio thread
+    // is stopped (prepareToPlay).
+    void prepare (double newSampleRate, int maximumBlockSize) noexcept
+    {
+        sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+        nominalBudgetNs = 1.0e9 * std::max (1, maximumBlockSize) / sampleRate;
+        clear();
+    }
+
+    // Any thread: the audio thread clears the counters at its next record()
+    void requestReset() noexcept                    { resetPending.store (true, std::memory_order_release); }
+
+    //==============================================================================
+    using Clock = std::chrono::steady_clock;
+
+   #if BUSGOVERNOR_CPU_METER
+    // The timed thread only (or whichever thread runs the timed code, one at
+    // a time: a pool worker in anticipative mode)
+    void record (Clock::duration elapsed, int numSamples) noexcept
+    {
+        if (resetPending.load (std::memory_order_relaxed) && resetPending.exchange (false, std::memory_order_acquire))
+            clear();
+
+        const auto ns = (std::uint64_t) std::max<Clock::rep> (0, std::chrono::duration_cast<std::chrono::nanoseconds> (elapsed).count());
+        const auto budget = (std::uint64_t) (1.0e9 * numSamples / sampleRate);
+
+        bump (buckets[(size_t) bucketOf (ns)]);
+        bump (blocks);
+        store (sumNs,     sumNs.load (std::memory_order_relaxed) + ns);
+        store (sumBudget, sumBudget.load (std::memory_order_relaxed) + budget);
+
+        if (ns > maxNs.load (std::memory_order_relaxed))
+            store (maxNs, ns);
+
+        if (ns > budget)
+            bump (overruns);
+    }
+
+    // Times its own lifetime: construct at the top of the timed function
+    struct ScopedTimer
+    {
+        ScopedTimer (BusGovernorCpuMeter& m, int n) noexcept : meter (m), numSamples (n), start (Clock::now()) {}
+        ~ScopedTimer() noexcept     { meter.record (Clock::now() - start, numSamples); }
+
+        BusGovernorCpuMeter& meter;
+        const int numSamples;
+        const Clock::time_point start;
+    };
+   #else
+    void record (Clock::duration, int) noexcept {}
+
+    struct ScopedTimer
+    {
+        ScopedTimer (BusGovernorCpuMeter&, int) noexcept {}
+    };
+   #endif
+
+    //==============================================================================
+    // Any thread
+    Stats getStats() const noexcept
+    {
+        Stats s;
+
+        if (! enabled)
+            return s;
+
+        std::array<std::uint64_t, numBuckets> counts;
+        std::uint64_t total = 0;
+
+        for (size_t i = 0; i < counts.size(); ++i)
+            total += counts[i] = buckets[i].load (std::memory_order_relaxed);
+
+        s.blocks   = blocks.load (std::memory_order_relaxed);
+        s.overruns = overruns.load (std::memory_order_relaxed);
+        s.maxNs    = (double) maxNs.load (std::memory_order_relaxed);
+        s.budgetNs = nominalBudgetNs;
+
+        if (s.blocks == 0 || total == 0)
+            return s;
+
+        const auto sum = (double) sumNs.load (std::memory_order_relaxed);
+        const auto audio = (double) sumBudget.load (std::memory_order_relaxed);
+
+        s.meanNs = sum / (double) s.blocks;
+        s.load   = audio > 0.0 ? sum / audio : 0.0;
+
+        // First bucket at which the cumulative count reaches 99%
+        const auto rank = (total * 99 + 99) / 100;
+        std::uint64_t seen = 0;
+        int i = 0;
+
+        while (i < numBuckets - 1 && (seen += counts[(size_t) i]) < rank)
+            ++i;
+
+        s.p99Ns = std::min ((double) bucketUpperEdge (i), s.maxNs);
+
+        if (nominalBudgetNs > 0.0)
+        {
+            s.p99Load = s.p99Ns / nominalBudgetNs;
+            s.maxLoad = s.maxNs / nominalBudgetNs;
+        }
+
+        return s;
+    }
+
+private:
+    //==============================================================================
+    // 3 mantissa bits per octave; bucket 0 holds everything below 64 ns
+    static constexpr int subBits    = 3;
+    static constexpr int minOctave  = 6;     // 2^6 ns
+    static constexpr int maxOctave  = 32;    // 2^32 ns
+    static constexpr int numBuckets = 1 + ((maxOctave - minOctave) << subBits);
+
+    static int highestBit (std::uint64_t x) noexcept
+    {
+        int bit = 0;
+
+        for (int step = 32; step > 0; step >>= 1)
+        {
+            if (x >> step)
+            {
+                x >>= step;
+                bit += step;
+            }
+        }
+
+        return bit;
+    }
+
+    static int bucketOf (std::uint64_t ns) noexcept
+    {
+        if (ns < (std::uint64_t (1) << minOctave))
+            return 0;
+
+        const int octave = highestBit (ns);
+
+        if (octave >= maxOctave)
+            return numBuckets - 1;
+
+        const auto sub = (int) ((ns >> (octave - subBits)) & ((1u << subBits) - 1));
+
+        return 1 + ((octave - minOctave) << subBits) + sub;
+    }
+
+    static std::uint64_t bucketUpperEdge (int bucket) noexcept
+    {
+        if (bucket == 0)
+            return std::uint64_t (1) << minOctave;
+
+        const int octave = minOctave + ((bucket - 1) >> subBits);
+        const auto sub = (std::uint64_t) ((bucket - 1) & ((1 << subBits) - 1));
+
+        return (std::uint64_t (1) << octave) + ((sub + 1) << (octave - subBits));
+    }
+
+    // Single writer: a plain load + store is enough and cheaper than fetch_add
+    static void bump (std::atomic<std::uint64_t>& c) noexcept   { store (c, c.load (std::memory_order_relaxed) + 1); }
+    static void store (std::atomic<std::uint64_t>& c, std::uint64_t v) noexcept   { c.store (v, std::memory_order_relaxed); }
+
+    void clear() noexcept
+    {
+        for (auto& b : buckets)
+            store (b, 0);
+
+        for (auto* c : { &blocks, &overruns, &sumNs, &sumBudget, &maxNs })
+            store (*c, 0);
+    }
+
+    //==============================================================================
+    double sampleRate = 44100.0;
+    double nominalBudgetNs = 0.0;
+
+    std::array<std::atomic<std::uint64_t>, numBuckets> buckets {};
+    std::atomic<std::uint64_t> blocks { 0 }, overruns { 0 };
+    std::atomic<std::uint64_t> sumNs { 0 }, sumBudget { 0 }, maxNs { 0 };
+
+    std::atomic<bool> resetPending { false };
+};
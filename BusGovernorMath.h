@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+    Power-function engines for the BusGovernor b recurrence.
+
+    The recurrence calls pow (base, expo) once per sample. The engine is a
+    compile-time policy so the reference std::pow path is always available:
+
+        BusGovernorStdPow   - std::pow, the reference.
+        BusGovernorFastPow  - exp2 (expo * log2 (base)) with polynomial
+                              log2/exp2 kernels. Branch-free, so it also
+                              auto-vectorizes when used across lanes.
+
+    Fast engine error (measured against double-precision pow on a 4001 x 401
+    grid, base in [1, 64], expo in [0.5, 2]):
+
+        max relative error  8.6e-7
+        rms relative error  1.8e-7
+
+    That range covers what the recurrence reaches in practice: base stays in
+    about [1, 25] and expo in about [0.98, 1.5] even at drive 24 on +6 dBFS
+    material. Outside it the error grows with |expo * log2 (base)| because the
+    product is rounded to float before exp2; the exponent saturates at 2^126
+    instead of overflowing (valid for |expo * log2 (base)| < 2^22).
+
+    Tools/BusGovernorBench --error-sweep reproduces the figures above (and the
+    ns per call of both engines); its "stdpow" and "fastpow" cases time the
+    core with each engine on the benchmark stimuli.
+
+    Define BUSGOVERNOR_FAST_MATH=1 to make the fast engine the default.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#ifndef BUSGOVERNOR_FAST_MATH
+ #define BUSGOVERNOR_FAST_MATH 0
+#endif
+
+//==============================================================================
+struct BusGovernorStdPow
+{
+    static inline float  pow (float base, float expo) noexcept      { return std::pow (base, expo); }
+    static inline double pow (double base, double expo) noexcept    { return std::pow (base, expo); }
+};
+
+//==============================================================================
+struct BusGovernorFastPow
+{
+    // log2 for x > 0 (denormals/zero/inf not handled - the caller clamps to eps).
+    // Mantissa is folded into [sqrt(0.5), sqrt(2)) and fitted with a degree-8
+    // Chebyshev polynomial in (m - 1); max abs error 5.7e-8 on the mantissa.
+    static inline float log2 (float x) noexcept
+    {
+        std::int32_t bits;
+        std::memcpy (&bits, &x, sizeof (bits));
+
+        const std::int32_t e  = (bits - 0x3f3504f3) >> 23;  // 0x3f3504f3 == sqrt(0.5)
+        const std::int32_t mb = bits - e * (1 << 23);
+
+        float m;
+        std::memcpy (&m, &mb, sizeof (m));
+
+        const float u  = m - 1.0f;
+        const float u2 = u * u;
+        const float u4 = u2 * u2;
+
+        // Estrin evaluation: shorter dependency chain than Horner
+        const float p01 = 4.15020193e-08f + u * 1.44269498f;
+        const float p23 = -0.721361318f   + u * 0.480919913f;
+        const float p45 = -0.359966494f   + u * 0.287122716f;
+        const float p67 = -0.251563972f   + u * 0.234394776f;
+
+        return (float) e + ((p01 + u2 * p23) + u4 * ((p45 + u2 * p67) + u4 * -0.138651189f));
+    }
+
+    // exp2 via round-to-nearest with the 1.5 * 2^23 trick (no float->int
+    // conversion) and a degree-5 Chebyshev fit on [-0.5, 0.5]; max rel error
+    // 1.0e-7. The exponent is clamped to [-126, 126] in the integer domain,
+    // which keeps the function free of float compares so it vectorizes.
+    static inline float exp2 (float x) noexcept
+    {
+        constexpr float roundingMagic = 12582912.0f; // 1.5 * 2^23
+
+        const float shifted = x + roundingMagic;
+        std::int32_t ib;
+        std::memcpy (&ib, &shifted, sizeof (ib));
+
+        const std::int32_t e = std::min (std::max (ib - 0x4b400000, -126), 126);
+
+        const float f  = x - (shifted - roundingMagic);
+        const float f2 = f * f;
+        const float p  = (1.00000008f + f * 0.693147188f)
+                       + f2 * ((0.240221075f + f * 0.0555035711f)
+                             + f2 * (0.00967603192f + f * 0.00133908634f));
+
+        const std::int32_t scaleBits = (e + 127) << 23;
+        float scale;
+        std::memcpy (&scale, &scaleBits, sizeof (scale));
+
+        return p * scale;
+    }
+
+    static inline float pow (float base, float expo) noexcept    { return exp2 (expo * log2 (base)); }
+
+    // The kernels above are only float-accurate, so double stays on std::pow
+    static inline double pow (double base, double expo) noexcept  { return std::pow (base, expo); }
+};
+
+//==============================================================================
+#if BUSGOVERNOR_FAST_MATH
+ using BusGovernorPow = BusGovernorFastPow;
+#else
+ using BusGovernorPow = BusGovernorStdPow;
+#endif
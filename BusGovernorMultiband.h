@@ -0,0 +1,691 @@
+/*
+  ==============================================================================
+
+    BusGovernorMultiband - splits a mono/stereo bus into 2..4 bands and runs
+    one governor per band, so low-end energy only pushes down its own band.
+
+    Crossovers are 4th-order Linkwitz-Riley (two cascaded Butterworth
+    sections) in a tree: crossover 0 splits off band 0, crossover 1 splits
+    the rest into band 1 and the rest, and so on. Every band also passes the
+    allpass of each crossover above it, so all bands carry the same phase.
+    With equal band gains the sum is an allpass of the input: flat magnitude
+    to rounding (2e-5 dB in float, measured over 4 bands).
+
+    Each band has its own a/b state, drive and pressure, and its detector
+    is the band's own |l + r|. The bands are the lanes of a BusGovernorBank,
+    so with the fast pow their recurrences advance together in one set of
+    vector registers. Measured per stereo frame at 48 kHz by stage (-O3,
+    AVX-512 dispatch, pink noise, 512-sample blocks, best of 3 runs):
+
+        bands                       1       2       3       4
+        fast pow   total         43.9    53.7    63.4    73.6
+                   crossovers     0.1     9.5    17.2    25.5
+                   bank          44.0    45.0    46.1    48.3
+                   sum            0.2     0.4     0.7     1.1
+        std::pow   total         47.3    58.8    74.7   102.1
+                   bank          47.5    50.1    57.8    78.1
+
+        BusGovernorCore (wideband, std::pow)    40.7
+
+    The bank stays close to single-band cost with the fast pow (4 bands
+    cost 10% more than 1): a lane block with at most 4 active lanes runs
+    the recurrence in 4-lane registers, at the latency of one narrow vector
+    update. The rest is the crossover tree, 18 second-order sections per
+    stereo frame at 4 bands (12 on the split path, 6 allpasses). In stereo
+    with 3 or 4 bands the sections run as a pipeline, one vector update
+    across all of them per sample (see splitPipelined); mono and 2 bands
+    have too few sections to pay for its routing and run crossover by
+    crossover. With per-crossover passes only and 16-lane blocks, 4 bands
+    cost 102.6 ns in the same session (2.5x the core); now they cost 1.7x
+    one band and 1.8x the wideband core. Four separate cores behind the
+    same crossovers would cost about 4 x 40.7 + 25.5 = 188 ns.
+    BusGovernorBench measures the bank and sum alone as its "lanes" cases.
+
+    The plugin instantiates it with BusGovernorPow, like the core, so the
+    default build (BUSGOVERNOR_FAST_MATH=0) keeps std::pow in the bands as
+    well. Those lanes run scalar, one pow per band and sample, so there the
+    bank grows with the band count too.
+
+    Band parameters and crossovers can be set outright or as targets that
+    the next process() call ramps to: the band parameters per sample in the
+    bank, across the whole call although the bank runs once per pass, and
+    the crossovers geometrically in rampStep-sample steps (the state-space
+    sections take coefficient changes without clicks). Eco mode does not
+    apply.
+
+    All memory is allocated in prepare(); process() never allocates.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "BusGovernorBank.h"
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+// Keeps GCC from fully unrolling a fixed-trip lane loop before the loop
+// vectorizer sees it (as in BusGovernorLoudness)
+#ifndef BUSGOVERNOR_VECTORIZE_LANES
+ #if defined (__GNUC__) && ! defined (__clang__)
+  #define BUSGOVERNOR_VECTORIZE_LANES _Pragma ("GCC unroll 1")
+ #else
+  #define BUSGOVERNOR_VECTORIZE_LANES
+ #endif
+#endif
+
+//==============================================================================
+// One Linkwitz-Riley crossover point for up to two channels.
+//
+// Each Butterworth section is the TPT state-variable filter written out as
+// a 2x2 state-space update (s' = A s + B x, outputs C s + D x, coefficients
+// expanded in double). Same states and responses as the usual yH/yB/yL
+// form, but the per-sample feedback path is one multiply-add deep instead
+// of five, which is what bounds a serial IIR.
+template <typename SampleType>
+struct BusGovernorCrossoverT
+{
+    static constexpr int maxChannels = 2;
+
+    void setCutoff (SampleType cutoffHz, double sampleRate) noexcept
+    {
+        const double nyquistSafe = 0.45 * sampleRate;
+        const double hz = std::min (std::max ((double) cutoffHz, 10.0), nyquistSafe);
+
+        const double g  = std::tan (3.14159265358979323846 * hz / sampleRate);
+        const double r2 = std::sqrt (2.0);
+        const double h  = 1.0 / (1.0 + r2 * g + g * g);
+
+        // yH, yB, yL as { x, s1, s2 } weights
+        const double yH[3] = { h, -h * (r2 + g), -h };
+        const double yB[3] = { g * yH[0], 1.0 + g * yH[1], g * yH[2] };
+        const double yL[3] = { g * yB[0], g * yB[1], 1.0 + g * yB[2] };
+
+        // s1' = 2 yB - s1, s2' = 2 yL - s2
+        c.b1 = (SampleType) (2.0 * yB[0]);  c.a11 = (SampleType) (2.0 * yB[1] - 1.0);  c.a12 = (SampleType) (2.0 * yB[2]);
+        c.b2 = (SampleType) (2.0 * yL[0]);  c.a21 = (SampleType) (2.0 * yL[1]);        c.a22 = (SampleType) (2.0 * yL[2] - 1.0);
+
+        // Lowpass yL and allpass yL - r2 yB + yH
+        c.lx = (SampleType) yL[0];  c.l1 = (SampleType) yL[1];  c.l2 = (SampleType) yL[2];
+
+        c.px = (SampleType) (yL[0] - r2 * yB[0] + yH[0]);
+        c.p1 = (SampleType) (yL[1] - r2 * yB[1] + yH[1]);
+        c.p2 = (SampleType) (yL[2] - r2 * yB[2] + yH[2]);
+    }
+
+    void reset() noexcept
+    {
+        for (auto& st : state)
+            st = {};
+    }
+
+    // One sample: returns the low band, high receives the high band
+    inline SampleType split (SampleType x, SampleType& high, int channel) noexcept
+    {
+        auto& st = state[(size_t) channel];
+
+        // Low + high is the first section's allpass
+        const SampleType ap  = c.px * x + c.p1 * st.s1 + c.p2 * st.s2;
+        const SampleType yL  = lowpass (x, st.s1, st.s2);
+        const SampleType yL2 = lowpass (yL, st.s3, st.s4);
+
+        high = ap - yL2;
+        return yL2;
+    }
+
+    // One sample through this crossover's allpass, with separate state for
+    // every band it is applied to
+    struct AllpassState { SampleType s1 = 0, s2 = 0; };
+
+    inline SampleType allpass (SampleType x, AllpassState& st) const noexcept
+    {
+        const SampleType y = c.px * x + c.p1 * st.s1 + c.p2 * st.s2;
+        step (x, st.s1, st.s2);
+        return y;
+    }
+
+    // Both sections share the state update and outputs; states are s1/s2
+    // for the first section and s3/s4 for the second. Public for kernels
+    // that run many sections side by side (BusGovernorMultiband's split).
+    struct Coefficients
+    {
+        SampleType a11 = 1, a12 = 0, b1 = 0, a21 = 0, a22 = 1, b2 = 0;   // state update
+        SampleType lx = 0, l1 = 0, l2 = 0;                               // lowpass out
+        SampleType px = 1, p1 = 0, p2 = 0;                               // allpass out
+    };
+
+    struct ChannelState { SampleType s1 = 0, s2 = 0, s3 = 0, s4 = 0; };
+
+    Coefficients c;
+    std::array<ChannelState, maxChannels> state {};
+
+private:
+    inline SampleType lowpass (SampleType x, SampleType& s1, SampleType& s2) const noexcept
+    {
+        const SampleType y = c.lx * x + c.l1 * s1 + c.l2 * s2;
+        step (x, s1, s2);
+        return y;
+    }
+
+    inline void step (SampleType x, SampleType& s1, SampleType& s2) const noexcept
+    {
+        const SampleType n1 = c.b1 * x + c.a11 * s1 + c.a12 * s2;
+        const SampleType n2 = c.b2 * x + c.a21 * s1 + c.a22 * s2;
+        s1 = n1;
+        s2 = n2;
+    }
+};
+
+//==============================================================================
+template <typename PowEngine = BusGovernorFastPow, typename SampleType = float>
+class BusGovernorMultibandT
+{
+public:
+    using Bank       = BusGovernorBankT<PowEngine, SampleType>;
+    using State      = typename Bank::State;
+    using Parameters = typename Bank::Parameters;
+    using Crossover  = BusGovernorCrossoverT<SampleType>;
+
+    static constexpr int maxBands    = 4;
+    static constexpr int maxChannels = Crossover::maxChannels;
+    static constexpr int chunkSize   = 256;   // samples split, governed and summed per pass
+    static constexpr int rampStep    = 32;    // crossover coefficient updates while ramping
+
+    //==============================================================================
+    // Allocates the band buffers. Not real-time safe; call before processing.
+    void prepare (double newSampleRate)
+    {
+        bank.prepare (maxBands);
+        bank.setNumActiveLanes (numBands);
+
+        bands.assign ((size_t) (maxBands * maxChannels * chunkSize), SampleType (0));
+
+        setSampleRate (newSampleRate);
+        reset();
+    }
+
+    // Clears the governors and the filters
+    void reset() noexcept
+    {
+        bank.reset();
+        resetFilters();
+    }
+
+    // The rate the bands run at (the oversampled rate inside oversampling).
+    // Clears the filters when it changes.
+    void setSampleRate (double newSampleRate) noexcept
+    {
+        if (newSampleRate == sampleRate || newSampleRate <= 0.0)
+            return;
+
+        sampleRate = newSampleRate;
+        orderTargets();
+
+        for (int k = 0; k < maxBands - 1; ++k)
+        {
+            cutoffs[(size_t) k] = targetCutoffs[(size_t) k];
+            crossovers[(size_t) k].setCutoff (cutoffs[(size_t) k], sampleRate);
+        }
+
+        resetFilters();
+    }
+
+    // 1..maxBands; 1 runs a single wideband lane. Clears the filters when it
+    // changes; each band keeps its governor state.
+    void setNumBands (int newNumBands) noexcept
+    {
+        newNumBands = std::min (std::max (1, newNumBands), maxBands);
+
+        if (newNumBands != numBands)
+        {
+            numBands = newNumBands;
+            bank.setNumActiveLanes (numBands);
+            resetFilters();
+        }
+    }
+
+    int getNumBands() const noexcept                        { return numBands; }
+
+    // index 0..maxBands - 2, between band index and band index + 1. Kept in
+    // [10 Hz, 0.45 * sampleRate], and never below the crossover before it:
+    // the next process() call raises a cutoff that would be, so the calls
+    // may come in any order. Takes effect at the start of that call.
+    void setCrossover (int index, float hz) noexcept
+    {
+        targetCutoffs[(size_t) index] = (SampleType) hz;
+        jumpCutoffs = true;
+    }
+
+    // Sweeps the crossover to hz across the next process() call
+    void setTargetCrossover (int index, float hz) noexcept     { targetCutoffs[(size_t) index] = (SampleType) hz; }
+
+    void setBandParameters (int band, const Parameters& p) noexcept         { bank.setLaneParameters (band, p); }
+    void setBandTargetParameters (int band, const Parameters& p) noexcept   { bank.setLaneTargetParameters (band, p); }
+    State getBandState (int band) const noexcept                      { return bank.getLaneState (band); }
+
+    // b across the active bands as the last process() call left them
+    BusGovernorBlockStats getBlockStats() const noexcept
+    {
+        BusGovernorBlockStats stats;
+        stats.minB = stats.maxB = (float) getBandState (0).b;
+
+        float sum = 0.0f;
+
+        for (int j = 0; j < numBands; ++j)
+        {
+            const auto b = (float) getBandState (j).b;
+            stats.minB = std::min (stats.minB, b);
+            stats.maxB = std::max (stats.maxB, b);
+            sum += b;
+        }
+
+        stats.meanB = sum / (float) numBands;
+        return stats;
+    }
+
+    //==============================================================================
+    // Processes in place. right may be nullptr (mono: each band's detector
+    // sees l + l).
+    void process (SampleType* left, SampleType* right, int numSamples) noexcept
+    {
+        const int numChannels = right != nullptr ? 2 : 1;
+        SampleType* io[maxChannels] = { left, right };
+
+        orderTargets();
+
+        if (jumpCutoffs)
+        {
+            sweepCrossovers (cutoffs, 1.0);
+            jumpCutoffs = false;
+        }
+
+        // Crossover sweeps: shorter passes, each ending on its own cutoffs.
+        // Geometric steps between two ordered sets keep every step ordered.
+        std::array<SampleType, maxBands - 1> sweepFrom = cutoffs;
+        bool sweeping = false;
+
+        for (int k = 0; k < numBands - 1; ++k)
+            sweeping = sweeping || cutoffs[(size_t) k] != targetCutoffs[(size_t) k];
+
+        const int passSize = sweeping ? rampStep : chunkSize;
+
+        for (int start = 0; start < numSamples; start += passSize)
+        {
+            const int n = std::min (passSize, numSamples - start);
+
+            if (sweeping)
+                sweepCrossovers (sweepFrom, (double) (start + n) / numSamples);
+
+            // ---- Split ----
+            splitChunk (io, numChannels, start, n);
+
+            // ---- Govern, bands in lanes ----
+            SampleType* laneLeft[maxBands];
+            SampleType* laneRight[maxBands];
+
+            for (int j = 0; j < numBands; ++j)
+            {
+                laneLeft[j]  = band (j, 0);
+                laneRight[j] = numChannels > 1 ? band (j, 1) : nullptr;
+            }
+
+            bank.process (laneLeft, laneRight, n, start, numSamples);
+
+            // ---- Sum ----
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                SampleType* out = io[ch] + start;
+                std::copy (band (0, ch), band (0, ch) + n, out);
+
+                for (int j = 1; j < numBands; ++j)
+                {
+                    const SampleType* x = band (j, ch);
+
+                    for (int s = 0; s < n; ++s)
+                        out[s] += x[s];
+                }
+            }
+        }
+    }
+
+private:
+    //==============================================================================
+    void orderTargets() noexcept
+    {
+        for (int k = 1; k < maxBands - 1; ++k)
+            targetCutoffs[(size_t) k] = std::max (targetCutoffs[(size_t) k], targetCutoffs[(size_t) k - 1]);
+    }
+
+    // Cutoffs at position t (0..1) of a geometric sweep to the targets
+    void sweepCrossovers (const std::array<SampleType, maxBands - 1>& from, double t) noexcept
+    {
+        for (int k = 0; k < maxBands - 1; ++k)
+        {
+            const auto to = targetCutoffs[(size_t) k];
+
+            if (from[(size_t) k] == to)
+                continue;
+
+            cutoffs[(size_t) k] = t >= 1.0 ? to : (SampleType) (from[(size_t) k] * std::pow ((double) to / from[(size_t) k], t));
+            crossovers[(size_t) k].setCutoff (cutoffs[(size_t) k], sampleRate);
+        }
+    }
+
+    void splitChunk (SampleType* const* io, int numChannels, int start, int n) noexcept
+    {
+        const bool stereo = numChannels > 1;
+
+        switch (numBands)
+        {
+            case 1:  stereo ? splitKernel<1, 2> (io, start, n) : splitKernel<1, 1> (io, start, n); break;
+            case 2:  stereo ? splitKernel<2, 2> (io, start, n) : splitKernel<2, 1> (io, start, n); break;
+            case 3:  stereo ? splitKernel<3, 2> (io, start, n) : splitKernel<3, 1> (io, start, n); break;
+            default: stereo ? splitKernel<4, 2> (io, start, n) : splitKernel<4, 1> (io, start, n); break;
+        }
+    }
+
+    template <int NB, int NC>
+    void splitKernel (SampleType* const* io, int start, int n) noexcept
+    {
+        SampleType* out[NB][NC];
+
+        for (int j = 0; j < NB; ++j)
+            for (int ch = 0; ch < NC; ++ch)
+                out[j][ch] = band (j, ch);
+
+        // The pipeline pays a fixed cost per step for routing its lanes, so
+        // it only wins with 10 or more of them (stereo with 3 or 4 bands)
+        if constexpr (NB == 1)
+        {
+            for (int ch = 0; ch < NC; ++ch)
+                std::copy (io[ch] + start, io[ch] + start + n, out[0][ch]);
+        }
+        else if constexpr (SplitStages<NB>::count * NC >= 10)
+        {
+            splitPipelined<NB, NC> (io, out, start, n);
+        }
+        else
+        {
+            splitPasses<NB, NC> (io, out, start, n);
+        }
+    }
+
+    // One pass per crossover k: split every channel's rest into band k and
+    // the new rest, and give the bands below k this crossover's allpass.
+    // Each filter is a serial recurrence; a pass holds several independent
+    // ones (channels, lower bands), so they overlap instead of running at
+    // the latency of a single chain.
+    template <int NB, int NC>
+    void splitPasses (SampleType* const* io, SampleType* const (*out)[NC], int start, int n) noexcept
+    {
+        for (int k = 0; k < NB - 1; ++k)
+        {
+            // Local copies so the filter states can stay in registers
+            Crossover xo = crossovers[(size_t) k];
+            typename Crossover::AllpassState ap[NB][NC];
+
+            for (int j = 0; j < k; ++j)
+                for (int ch = 0; ch < NC; ++ch)
+                    ap[j][ch] = allpassState (j, k, ch);
+
+            SampleType* in[NC];
+
+            for (int ch = 0; ch < NC; ++ch)
+                in[ch] = k == 0 ? io[ch] + start : out[k][ch];
+
+            for (int s = 0; s < n; ++s)
+            {
+                for (int ch = 0; ch < NC; ++ch)
+                {
+                    SampleType high;
+                    out[k][ch][s]     = xo.split (in[ch][s], high, ch);
+                    out[k + 1][ch][s] = high;
+
+                    for (int j = 0; j < k; ++j)
+                        out[j][ch][s] = xo.allpass (out[j][ch][s], ap[j][ch]);
+                }
+            }
+
+            crossovers[(size_t) k] = xo;
+
+            for (int j = 0; j < k; ++j)
+                for (int ch = 0; ch < NC; ++ch)
+                    allpassState (j, k, ch) = ap[j][ch];
+        }
+    }
+
+    // The split as a pipeline. Each second-order section of the tree is a
+    // lane: per channel, crossover k's two sections are stages 2k and
+    // 2k + 1, and the allpass of crossover k on band j < k is one more
+    // stage. A stage runs as many samples behind the input as there are
+    // sections in front of it, so no section feeds another within a step
+    // and a step is one vector update across every lane, instead of up to
+    // 18 serial section updates per stereo frame. The lanes fill over the
+    // first steps of a pass and drain over the last; those steps leave a
+    // lane's state alone while it has no sample.
+    template <int NB>
+    struct SplitStages
+    {
+        static constexpr int numSplit = 2 * (NB - 1);
+        static constexpr int count    = numSplit + (NB - 1) * (NB - 2) / 2;
+        static constexpr int depth    = 2 * NB - 3;   // delay of the last two bands
+
+        static constexpr int allpass (int j, int k) noexcept      { return numSplit + k * (k - 1) / 2 + j; }
+        static constexpr int bandDelay (int j) noexcept           { return j < NB - 2 ? j + NB - 1 : depth; }
+    };
+
+    template <int NumLanes>
+    struct SplitLanes
+    {
+        // Per lane: its crossover's coefficients, state, input and outputs
+        SampleType a11[NumLanes], a12[NumLanes], b1[NumLanes], a21[NumLanes], a22[NumLanes], b2[NumLanes];
+        SampleType lx[NumLanes], l1[NumLanes], l2[NumLanes], px[NumLanes], p1[NumLanes], p2[NumLanes];
+        SampleType s1[NumLanes], s2[NumLanes];
+        SampleType x[NumLanes], yL[NumLanes], yA[NumLanes];
+        int delay[NumLanes];
+
+        // Each crossover's first-section allpass from the step before, per channel
+        SampleType apLast[maxBands - 1][maxChannels];
+    };
+
+    template <int NB, int NC>
+    void splitPipelined (SampleType* const* io, SampleType* const (*out)[NC], int start, int n) noexcept
+    {
+        using Stages = SplitStages<NB>;
+        constexpr int numLanes = (Stages::count * NC + 3) / 4 * 4;   // whole SSE registers
+
+        SplitLanes<numLanes> p {};
+
+        const SampleType* in[NC];
+
+        for (int ch = 0; ch < NC; ++ch)
+            in[ch] = io[ch] + start;
+
+        for (int m = 0; m < Stages::count; ++m)
+        {
+            // Stage m's crossover, and the band its allpass runs on
+            const int k = m < Stages::numSplit ? m / 2 : allpassCrossover<NB> (m);
+            const int j = m < Stages::numSplit ? -1 : m - Stages::allpass (0, k);
+            const auto& c = crossovers[(size_t) k].c;
+
+            for (int ch = 0; ch < NC; ++ch)
+            {
+                const int i = m * NC + ch;
+
+                p.a11[i] = c.a11;  p.a12[i] = c.a12;  p.b1[i] = c.b1;
+                p.a21[i] = c.a21;  p.a22[i] = c.a22;  p.b2[i] = c.b2;
+                p.lx[i]  = c.lx;   p.l1[i]  = c.l1;   p.l2[i] = c.l2;
+                p.px[i]  = c.px;   p.p1[i]  = c.p1;   p.p2[i] = c.p2;
+
+                if (j < 0)
+                {
+                    const auto& st = crossovers[(size_t) k].state[(size_t) ch];
+                    p.s1[i] = (m & 1) == 0 ? st.s1 : st.s3;
+                    p.s2[i] = (m & 1) == 0 ? st.s2 : st.s4;
+                    p.delay[i] = m;
+                }
+                else
+                {
+                    p.s1[i] = allpassState (j, k, ch).s1;
+                    p.s2[i] = allpassState (j, k, ch).s2;
+                    p.delay[i] = j + k + 1;
+                }
+            }
+        }
+
+        const int fill = std::min (Stages::depth, n);
+        int t = 0;
+
+        for (; t < fill; ++t)                  splitStep<NB, NC, true> (p, in, out, t, n);
+        for (; t < n; ++t)                     splitStep<NB, NC, false> (p, in, out, t, n);
+        for (; t < n + Stages::depth; ++t)     splitStep<NB, NC, true> (p, in, out, t, n);
+
+        for (int m = 0; m < Stages::count; ++m)
+        {
+            const int k = m < Stages::numSplit ? m / 2 : allpassCrossover<NB> (m);
+            const int j = m < Stages::numSplit ? -1 : m - Stages::allpass (0, k);
+
+            for (int ch = 0; ch < NC; ++ch)
+            {
+                const int i = m * NC + ch;
+
+                if (j < 0)
+                {
+                    auto& st = crossovers[(size_t) k].state[(size_t) ch];
+                    ((m & 1) == 0 ? st.s1 : st.s3) = p.s1[i];
+                    ((m & 1) == 0 ? st.s2 : st.s4) = p.s2[i];
+                }
+                else
+                {
+                    allpassState (j, k, ch) = { p.s1[i], p.s2[i] };
+                }
+            }
+        }
+    }
+
+    template <int NB>
+    static constexpr int allpassCrossover (int stage) noexcept
+    {
+        int k = 1;
+
+        while (k < NB - 2 && stage >= SplitStages<NB>::allpass (0, k + 1))
+            ++k;
+
+        return k;
+    }
+
+    // Step t of a pass: the lane with delay d runs sample t - d. Edge steps
+    // (filling or draining) only update the lanes that have a sample.
+    template <int NB, int NC, bool edge, typename Lanes>
+    static BUSGOVERNOR_FORCE_INLINE void splitStep (Lanes& p, const SampleType* const* in, SampleType* const (*out)[NC],
+                                                    int t, int n) noexcept
+    {
+        using Stages = SplitStages<NB>;
+        constexpr int numLanes = (int) (sizeof (p.x) / sizeof (p.x[0]));
+
+        for (int ch = 0; ch < NC; ++ch)
+            p.x[ch] = (edge && t >= n) ? SampleType (0) : in[ch][t];
+
+        BUSGOVERNOR_VECTORIZE_LANES
+        for (int i = 0; i < numLanes; ++i)
+        {
+            const SampleType x = p.x[i], s1 = p.s1[i], s2 = p.s2[i];
+
+            p.yL[i] = p.lx[i] * x + p.l1[i] * s1 + p.l2[i] * s2;
+            p.yA[i] = p.px[i] * x + p.p1[i] * s1 + p.p2[i] * s2;
+
+            const SampleType n1 = p.b1[i] * x + p.a11[i] * s1 + p.a12[i] * s2;
+            const SampleType n2 = p.b2[i] * x + p.a21[i] * s1 + p.a22[i] * s2;
+
+            if (edge)
+            {
+                const bool live = (unsigned) (t - p.delay[i]) < (unsigned) n;
+                p.s1[i] = live ? n1 : s1;
+                p.s2[i] = live ? n2 : s2;
+            }
+            else
+            {
+                p.s1[i] = n1;
+                p.s2[i] = n2;
+            }
+        }
+
+        for (int ch = 0; ch < NC; ++ch)
+        {
+            const auto lane = [ch] (int m) { return m * NC + ch; };
+
+            // Crossover k's high band: the first section's allpass (one
+            // step older) minus the second section's lowpass
+            SampleType high[NB - 1];
+
+            for (int k = 0; k < NB - 1; ++k)
+            {
+                high[k] = p.apLast[k][ch] - p.yL[lane (2 * k + 1)];
+                p.apLast[k][ch] = p.yA[lane (2 * k)];
+            }
+
+            // Inputs for the next step
+            for (int k = 0; k < NB - 1; ++k)
+            {
+                p.x[lane (2 * k + 1)] = p.yL[lane (2 * k)];
+
+                if (k > 0)
+                    p.x[lane (2 * k)] = high[k - 1];
+
+                for (int j = 0; j < k; ++j)
+                    p.x[lane (Stages::allpass (j, k))] = j == k - 1 ? p.yL[lane (2 * j + 1)]
+                                                                    : p.yA[lane (Stages::allpass (j, k - 1))];
+            }
+
+            // Bands that finished a sample
+            for (int j = 0; j < NB; ++j)
+            {
+                const int s = t - Stages::bandDelay (j);
+
+                if (edge && (s < 0 || s >= n))
+                    continue;
+
+                out[j][ch][s] = j < NB - 2  ? p.yA[lane (Stages::allpass (j, NB - 2))]
+                              : j == NB - 2 ? p.yL[lane (2 * j + 1)]
+                                            : high[NB - 2];
+            }
+        }
+    }
+
+    SampleType* band (int j, int ch) noexcept
+    {
+        return bands.data() + (size_t) ((j * maxChannels + ch) * chunkSize);
+    }
+
+    typename Crossover::AllpassState& allpassState (int j, int k, int ch) noexcept
+    {
+        return allpassStates[(size_t) ((j * (maxBands - 1) + k) * maxChannels + ch)];
+    }
+
+    void resetFilters() noexcept
+    {
+        for (auto& x : crossovers)
+            x.reset();
+
+        for (auto& st : allpassStates)
+            st = {};
+    }
+
+    //==============================================================================
+    Bank bank;
+    int numBands = 1;
+    double sampleRate = 0.0;
+
+    std::array<SampleType, maxBands - 1> cutoffs { SampleType (200), SampleType (1500), SampleType (6000) };
+    std::array<SampleType, maxBands - 1> targetCutoffs = cutoffs;
+    bool jumpCutoffs = false;   // setCrossover: no sweep at the next process()
+    std::array<Crossover, maxBands - 1> crossovers;
+    std::array<typename Crossover::AllpassState, maxBands * (maxBands - 1) * maxChannels> allpassStates {};
+
+    // One chunk per band and channel, [band][channel][sample]
+    std::vector<SampleType> bands;
+};
+
+using BusGovernorMultiband = BusGovernorMultibandT<>;
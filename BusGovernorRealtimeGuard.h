@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+
+    BusGovernorRealtimeGuard - marks code that must stay real-time safe.
+
+    processBlock (and a pool worker running an anticipated block) opens a
+    ScopedAudioThread; anything on that thread until it closes must not
+    allocate, lock or block. The marker is a thread-local depth counter and
+    nothing more: a test build (Tools/BusGovernorRealtimeCheck.cpp) links
+    in interposers for malloc/free, mutexes and blocking syscalls that
+    consult it and abort with a stack trace on the first violation.
+
+    There is no way to allow a call inside a guarded scope: work that has
+    to lock (the host's latency notification, for one) is handed to the
+    message thread instead.
+
+    Define BUSGOVERNOR_RT_GUARD=1 for the test build only; by default every
+    scope here is an empty object.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#ifndef BUSGOVERNOR_RT_GUARD
+ #define BUSGOVERNOR_RT_GUARD 0
+#endif
+
+//==============================================================================
+struct BusGovernorRealtimeGuard
+{
+    static constexpr bool enabled = BUSGOVERNOR_RT_GUARD != 0;
+
+   #if BUSGOVERNOR_RT_GUARD
+    // Guarded scopes open on this thread
+    static int& depth() noexcept
+    {
+        static thread_local int d = 0;
+        return d;
+    }
+
+    static bool isActive() noexcept     { return depth() > 0; }
+
+    struct ScopedAudioThread
+    {
+        ScopedAudioThread() noexcept    { ++depth(); }
+        ~ScopedAudioThread() noexcept   { --depth(); }
+    };
+   #else
+    static bool isActive() noexcept     { return false; }
+
+    struct ScopedAudioThread
+    {
+        ScopedAudioThread() noexcept {}
+    };
+   #endif
+};
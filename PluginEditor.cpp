@@ -27,9 +27,12 @@ static void setupLabel (juce::Label& l, const juce::String& text, juce::Componen
 
 //==============================================================================
 BusGovernorAudioProcessorEditor::BusGovernorAudioProcessorEditor (BusGovernorAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
+    : AudioProcessorEditor (&p), audioProcessor (p), spectrum (p.getAnalyzerTap())
 {
-    setSize (400, 300);
+    spectrumFrame.input.fill (BusGovernorSpectrumAnalyzer::floorDb);
+    spectrumFrame.output.fill (BusGovernorSpectrumAnalyzer::floorDb);
+
+    setSize (400, 390);
 
     // Load background once (cached)
     backgroundImage = juce::ImageCache::getFromMemory (
@@ -63,15 +66,89 @@ BusGovernorAudioProcessorEditor::BusGovernorAudioProcessorEditor (BusGovernorAud
                                                            BusGovernorAudioProcessor::paramVolumeId,
                                                            volumeSlider);
 
+    matchAttachment = std::make_unique<ButtonAttachment> (audioProcessor.apvts,
+                                                          BusGovernorAudioProcessor::paramAutoMatchId,
+                                                          matchButton);
+
+    // ---- Loudness readout, auto match and integrated reset ----
+    for (auto* l : { &inLoudnessLabel, &outLoudnessLabel })
+    {
+        l->setFont (11.0f);
+        l->setJustificationType (juce::Justification::centredLeft);
+        l->setColour (juce::Label::textColourId, juce::Colours::white.withAlpha (0.8f));
+        l->setInterceptsMouseClicks (false, false);
+        addAndMakeVisible (*l);
+    }
+
+    matchButton.setColour (juce::ToggleButton::textColourId, juce::Colours::white.withAlpha (0.8f));
+    addAndMakeVisible (matchButton);
+
+    loudnessResetButton.onClick = [this] { audioProcessor.resetLoudness(); };
+    addAndMakeVisible (loudnessResetButton);
+
+    updateLoudnessReadout();
+
+    // CPU readout (hidden when the meter is compiled out)
+    cpuLabel.setFont (11.0f);
+    cpuLabel.setJustificationType (juce::Justification::centredLeft);
+    cpuLabel.setColour (juce::Label::textColourId, juce::Colours::white.withAlpha (0.65f));
+    cpuLabel.setInterceptsMouseClicks (false, false);
+    addChildComponent (cpuLabel);
+    cpuLabel.setVisible (BusGovernorCpuMeter::enabled);
+
+    // Records queued while no editor was open are stale
+    while (audioProcessor.popTelemetry (telemetry.data(), (int) telemetry.size()) > 0) {}
+
+    analysisThread->add (spectrum);
+
     startTimerHz (30); // smooth needle, low CPU
 }
 
-BusGovernorAudioProcessorEditor::~BusGovernorAudioProcessorEditor() {}
+BusGovernorAudioProcessorEditor::~BusGovernorAudioProcessorEditor()
+{
+    analysisThread->remove (spectrum);
+}
 
 //==============================================================================
 void BusGovernorAudioProcessorEditor::timerCallback()
 {
-    const float b = audioProcessor.bMeter.load (std::memory_order_relaxed);
+    // Drain everything since the last frame; the needle follows the peak so
+    // short transients between frames still register
+    float peakB = -1.0f, peakReductionDb = 0.0f;
+
+    for (int n; (n = audioProcessor.popTelemetry (telemetry.data(), (int) telemetry.size())) > 0;)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            peakB = juce::jmax (peakB, telemetry[(size_t) i].maxB);
+            peakReductionDb = juce::jmax (peakReductionDb, telemetry[(size_t) i].gainReductionDb);
+        }
+    }
+
+    bool analyzerChanged = false;
+
+    // The trace only scrolls while the host is processing
+    if (peakB >= 0.0f)
+    {
+        meterB = peakB;
+
+        gainReductionTrace[(size_t) traceNext] = peakReductionDb;
+        traceNext = (traceNext + 1) % traceLength;
+        updateGainReductionPath();
+        analyzerChanged = true;
+    }
+
+    if (const auto* frame = spectrum.fetchNewFrame())
+    {
+        spectrumFrame = *frame;
+        updateSpectrumPaths();
+        analyzerChanged = true;
+    }
+
+    if (analyzerChanged)
+        repaint (analyzerArea);
+
+    const float b = meterB;
 
     // Map b -> needle amount (0..1). b ~ 1 => near zero.
     float target = std::log1p (juce::jmax (0.0f, b - 1.0f));   // 0..inf
@@ -80,102 +157,310 @@ void BusGovernorAudioProcessorEditor::timerCallback()
     // Mechanical-ish smoothing
     lamp = 0.92f * lamp + 0.08f * target;
 
-    repaint();
+    // The needle repaints on its own; skip frames where it wouldn't visibly change
+    if (std::abs (lamp - paintedLamp) > 0.001f)
+        repaint (needleArea);
+
+    if (--loudnessRefreshCountdown <= 0)
+    {
+        loudnessRefreshCountdown = 3;   // the meter publishes every 100 ms
+        updateLoudnessReadout();
+    }
+
+    if (BusGovernorCpuMeter::enabled && --cpuRefreshCountdown <= 0)
+    {
+        cpuRefreshCountdown = 15;   // ~2 Hz at 30 fps
+        updateCpuReadout();
+    }
 }
 
-void BusGovernorAudioProcessorEditor::paint (juce::Graphics& g)
+// Average load, p99 and worst block as a share of one block's budget, and
+// how many blocks missed the host's deadline. Inline, "CPU" is processBlock
+// on the host thread. In anticipative mode the DSP runs on a pool worker:
+// "worker" is its load and p99, "host" the p99 of what is left on the host
+// thread, and "inline" the share of blocks the pool did not start in time.
+void BusGovernorAudioProcessorEditor::updateCpuReadout()
+{
+    const auto host = audioProcessor.getHostCpuStats();
+
+    if (host.blocks == 0)
+    {
+        cpuLabel.setText ("CPU -", juce::dontSendNotification);
+        return;
+    }
+
+    juce::String text;
+
+    if (audioProcessor.isAnticipating())
+    {
+        const auto worker = audioProcessor.getCpuStats();
+        const auto ahead = audioProcessor.getAnticipationStats();
+
+        text = juce::String::formatted ("worker %.1f%%  p99 %.1f%%  host p99 %.1f%%  xruns %llu",
+                                        100.0 * worker.load, 100.0 * worker.p99Load, 100.0 * host.p99Load,
+                                        (unsigned long long) host.overruns);
+
+        if (ahead.blocks > 0)
+            text << juce::String::formatted ("  inline %.1f%%", 100.0 * (double) ahead.fallbacks / (double) ahead.blocks);
+    }
+    else
+    {
+        text = juce::String::formatted ("CPU %.1f%%  p99 %.1f%%  max %.1f%%  xruns %llu",
+                                        100.0 * host.load, 100.0 * host.p99Load, 100.0 * host.maxLoad,
+                                        (unsigned long long) host.overruns);
+    }
+
+    cpuLabel.setText (text, juce::dontSendNotification);
+}
+
+// Momentary, short-term and integrated LUFS plus crest factor per side;
+// the output line also shows the auto match trim while it is on
+void BusGovernorAudioProcessorEditor::updateLoudnessReadout()
+{
+    auto lufs = [] (float v)
+    {
+        return v > (float) BusGovernorLoudness::absoluteGate ? juce::String (v, 1) : juce::String ("-inf");
+    };
+
+    auto line = [&lufs] (const char* side, const BusGovernorLoudness::Readout& r)
+    {
+        return juce::String (side) + "  M " + lufs (r.momentary) + "  S " + lufs (r.shortTerm)
+                 + "  I " + lufs (r.integrated) + "  crest " + juce::String (r.crestDb, 1);
+    };
+
+    inLoudnessLabel.setText (line ("IN ", audioProcessor.getInputLoudness()), juce::dontSendNotification);
+
+    auto out = line ("OUT", audioProcessor.getOutputLoudness());
+
+    if (matchButton.getToggleState())
+        out << "  match " << juce::String (audioProcessor.getMatchGainDb(), 1) << " dB";
+
+    outLoudnessLabel.setText (out, juce::dontSendNotification);
+}
+
+//==============================================================================
+// Analyzer scales: spectrum 0 dB at the top down to spectrumRangeDb at the
+// bottom; gain reduction 0 dB at the top, growing down to traceRangeDb
+static constexpr float spectrumRangeDb = -90.0f;
+static constexpr float traceRangeDb = 12.0f;
+
+// Points are log-spaced, so x is linear in the point index
+void BusGovernorAudioProcessorEditor::updateSpectrumPaths()
+{
+    const auto area = analyzerArea.toFloat();
+    constexpr int numPoints = BusGovernorSpectrumAnalyzer::numPoints;
+
+    auto x = [&area] (int k)        { return area.getX() + area.getWidth() * (float) k / (float) (numPoints - 1); };
+    auto y = [&area] (float db)     { return area.getY() + area.getHeight() * juce::jlimit (0.0f, 1.0f, db / spectrumRangeDb); };
+
+    inputSpectrumPath.clear();
+    inputSpectrumPath.preallocateSpace (3 * numPoints + 8);
+    inputSpectrumPath.startNewSubPath (area.getBottomLeft());
+
+    outputSpectrumPath.clear();
+    outputSpectrumPath.preallocateSpace (3 * numPoints + 4);
+
+    for (int k = 0; k < numPoints; ++k)
+    {
+        inputSpectrumPath.lineTo (x (k), y (spectrumFrame.input[(size_t) k]));
+
+        if (k == 0)
+            outputSpectrumPath.startNewSubPath (x (k), y (spectrumFrame.output[(size_t) k]));
+        else
+            outputSpectrumPath.lineTo (x (k), y (spectrumFrame.output[(size_t) k]));
+    }
+
+    inputSpectrumPath.lineTo (area.getBottomRight());
+    inputSpectrumPath.closeSubPath();
+}
+
+// Oldest point on the left, newest on the right
+void BusGovernorAudioProcessorEditor::updateGainReductionPath()
+{
+    const auto area = analyzerArea.toFloat();
+
+    gainReductionPath.clear();
+    gainReductionPath.preallocateSpace (3 * traceLength + 4);
+
+    for (int i = 0; i < traceLength; ++i)
+    {
+        const float db = gainReductionTrace[(size_t) ((traceNext + i) % traceLength)];
+        const float px = area.getX() + area.getWidth() * (float) i / (float) (traceLength - 1);
+        const float py = area.getY() + area.getHeight() * juce::jlimit (0.0f, 1.0f, db / traceRangeDb);
+
+        if (i == 0)
+            gainReductionPath.startNewSubPath (px, py);
+        else
+            gainReductionPath.lineTo (px, py);
+    }
+}
+
+void BusGovernorAudioProcessorEditor::drawAnalyzer (juce::Graphics& g) const
 {
+    const juce::Graphics::ScopedSaveState state (g);
+    g.reduceClipRegion (analyzerArea);
+
+    g.setColour (juce::Colours::white.withAlpha (0.14f));
+    g.fillPath (inputSpectrumPath);
+
+    g.setColour (juce::Colours::white.withAlpha (0.7f));
+    g.strokePath (outputSpectrumPath, juce::PathStrokeType (1.2f));
+
+    g.setColour (juce::Colours::orange.withAlpha (0.85f));
+    g.strokePath (gainReductionPath, juce::PathStrokeType (1.5f));
+}
+
+//==============================================================================
+// Gauge arc range
+static constexpr float gaugeStartA = juce::MathConstants<float>::pi * 1.15f;
+static constexpr float gaugeEndA   = juce::MathConstants<float>::pi * 1.85f;
+
+void BusGovernorAudioProcessorEditor::renderStaticLayer (float scale)
+{
+    const auto bounds = getLocalBounds();
+
+    staticLayer = juce::Image (juce::Image::RGB,
+                               juce::jmax (1, juce::roundToInt ((float) bounds.getWidth()  * scale)),
+                               juce::jmax (1, juce::roundToInt ((float) bounds.getHeight() * scale)),
+                               false);
+    staticLayerScale = scale;
+
+    juce::Graphics g (staticLayer);
+    g.addTransform (juce::AffineTransform::scale (scale));
+
     g.fillAll (juce::Colours::black);
 
     // Background
     if (backgroundImage.isValid())
-        g.drawImage (backgroundImage, getLocalBounds().toFloat());
+        g.drawImage (backgroundImage, bounds.toFloat());
 
     // Slight dark overlay so text & needle pop
     g.setColour (juce::Colours::black.withAlpha (0.22f));
-    g.fillRect (getLocalBounds());
+    g.fillRect (bounds);
 
     // Title
     g.setColour (juce::Colours::white.withAlpha (0.9f));
     g.setFont (15.0f);
     g.drawFittedText ("BusGovernor v2.0 - Harmonious Records",
-                      getLocalBounds().reduced (8),
+                      bounds.reduced (8),
                       juce::Justification::topLeft,
                       1);
 
-    // ---- Governor Needle (driven by b) ----
+    // ---- Gauge face ----
+    const auto c = gaugeBounds.getCentre();
+    const float size = gaugeBounds.getWidth();
+    const float r = size * 0.44f;      // arc radius
+    const float thickness = 3.5f;
+
+    // Background arc (Path for older JUCE compatibility)
+    g.setColour (juce::Colours::white.withAlpha (0.18f));
+    juce::Path arcPath;
+    arcPath.addArc (c.x - r, c.y - r,
+                    r * 2.0f, r * 2.0f,
+                    gaugeStartA, gaugeEndA,
+                    true);
+    g.strokePath (arcPath, juce::PathStrokeType (thickness));
+
+    // Tick marks
+    g.setColour (juce::Colours::white.withAlpha (0.12f));
+    const int ticks = 7;
+    for (int i = 0; i < ticks; ++i)
     {
-        auto area = getLocalBounds().toFloat();
+        float t = (float) i / (float) (ticks - 1);
+        float a = gaugeStartA + t * (gaugeEndA - gaugeStartA);
 
-        // Gauge bounds (top-right)
-        auto gauge = area.removeFromTop (90.0f).removeFromRight (120.0f).reduced (10.0f);
+        float x1 = c.x + std::cos (a) * (r - 2.0f);
+        float y1 = c.y + std::sin (a) * (r - 2.0f);
+        float x2 = c.x + std::cos (a) * (r + 7.0f);
+        float y2 = c.y + std::sin (a) * (r + 7.0f);
 
-        // Make it square-ish
-        float size = juce::jmin (gauge.getWidth(), gauge.getHeight());
-        gauge = gauge.withSizeKeepingCentre (size, size);
-
-        auto c = gauge.getCentre();
-        float r = size * 0.44f;      // arc radius
-        float thickness = 3.5f;
-
-        // Arc range
-        const float startA = juce::MathConstants<float>::pi * 1.15f;
-        const float endA   = juce::MathConstants<float>::pi * 1.85f;
-
-        // Background arc (Path for older JUCE compatibility)
-        g.setColour (juce::Colours::white.withAlpha (0.18f));
-        juce::Path arcPath;
-        arcPath.addArc (c.x - r, c.y - r,
-                        r * 2.0f, r * 2.0f,
-                        startA, endA,
-                        true);
-        g.strokePath (arcPath, juce::PathStrokeType (thickness));
-
-        // Tick marks
-        g.setColour (juce::Colours::white.withAlpha (0.12f));
-        const int ticks = 7;
-        for (int i = 0; i < ticks; ++i)
-        {
-            float t = (float) i / (float) (ticks - 1);
-            float a = startA + t * (endA - startA);
+        g.drawLine (x1, y1, x2, y2, 1.0f);
+    }
 
-            float x1 = c.x + std::cos (a) * (r - 2.0f);
-            float y1 = c.y + std::sin (a) * (r - 2.0f);
-            float x2 = c.x + std::cos (a) * (r + 7.0f);
-            float y2 = c.y + std::sin (a) * (r + 7.0f);
+    // Label
+    g.setColour (juce::Colours::white.withAlpha (0.65f));
+    g.setFont (11.0f);
+    g.drawFittedText ("GOV",
+                      gaugeBounds.toNearestInt().withTrimmedTop ((int) (size * 0.62f)),
+                      juce::Justification::centredTop, 1);
 
-            g.drawLine (x1, y1, x2, y2, 1.0f);
-        }
+    // ---- Analyzer panel: decade and 30 dB grid ----
+    const auto panel = analyzerArea.toFloat();
 
-        // Needle angle from smoothed value (lamp is now needle 0..1)
-        float needleA = startA + lamp * (endA - startA);
-
-        // Needle shadow
-        g.setColour (juce::Colours::black.withAlpha (0.35f));
-        g.drawLine (c.x + 1.0f, c.y + 1.0f,
-                    c.x + 1.0f + std::cos (needleA) * (r - 6.0f),
-                    c.y + 1.0f + std::sin (needleA) * (r - 6.0f),
-                    3.0f);
-
-        // Needle
-        g.setColour (juce::Colours::white.withAlpha (0.85f));
-        g.drawLine (c.x, c.y,
-                    c.x + std::cos (needleA) * (r - 6.0f),
-                    c.y + std::sin (needleA) * (r - 6.0f),
-                    2.6f);
-
-        // Hub
-        g.setColour (juce::Colours::white.withAlpha (0.35f));
-        g.fillEllipse (c.x - 5.0f, c.y - 5.0f, 10.0f, 10.0f);
-        g.setColour (juce::Colours::white.withAlpha (0.16f));
-        g.drawEllipse (c.x - 5.0f, c.y - 5.0f, 10.0f, 10.0f, 1.0f);
-
-        // Label
-        g.setColour (juce::Colours::white.withAlpha (0.65f));
-        g.setFont (11.0f);
-        g.drawFittedText ("GOV",
-                          gauge.toNearestInt().withTrimmedTop ((int) (size * 0.62f)),
-                          juce::Justification::centredTop, 1);
+    g.setColour (juce::Colours::black.withAlpha (0.35f));
+    g.fillRect (panel);
+
+    g.setFont (9.0f);
+
+    for (const float f : { 100.0f, 1000.0f, 10000.0f })
+    {
+        const float x = panel.getX() + panel.getWidth()
+                          * std::log (f / BusGovernorSpectrumAnalyzer::minFrequency)
+                          / std::log (BusGovernorSpectrumAnalyzer::maxFrequency / BusGovernorSpectrumAnalyzer::minFrequency);
+
+        g.setColour (juce::Colours::white.withAlpha (0.1f));
+        g.drawVerticalLine (juce::roundToInt (x), panel.getY(), panel.getBottom());
+
+        g.setColour (juce::Colours::white.withAlpha (0.4f));
+        g.drawText (f < 1000.0f ? "100" : (f < 10000.0f ? "1k" : "10k"),
+                    juce::Rectangle<float> (x + 2.0f, panel.getBottom() - 11.0f, 24.0f, 10.0f),
+                    juce::Justification::centredLeft, false);
+    }
+
+    g.setColour (juce::Colours::white.withAlpha (0.1f));
+
+    for (const float db : { -30.0f, -60.0f })
+        g.drawHorizontalLine (juce::roundToInt (panel.getY() + panel.getHeight() * db / spectrumRangeDb),
+                              panel.getX(), panel.getRight());
+}
+
+void BusGovernorAudioProcessorEditor::drawNeedle (juce::Graphics& g) const
+{
+    const auto c = gaugeBounds.getCentre();
+    const float r = gaugeBounds.getWidth() * 0.44f;
+
+    // Needle angle from smoothed value (lamp is now needle 0..1)
+    float needleA = gaugeStartA + lamp * (gaugeEndA - gaugeStartA);
+
+    // Needle shadow
+    g.setColour (juce::Colours::black.withAlpha (0.35f));
+    g.drawLine (c.x + 1.0f, c.y + 1.0f,
+                c.x + 1.0f + std::cos (needleA) * (r - 6.0f),
+                c.y + 1.0f + std::sin (needleA) * (r - 6.0f),
+                3.0f);
+
+    // Needle
+    g.setColour (juce::Colours::white.withAlpha (0.85f));
+    g.drawLine (c.x, c.y,
+                c.x + std::cos (needleA) * (r - 6.0f),
+                c.y + std::sin (needleA) * (r - 6.0f),
+                2.6f);
+
+    // Hub (sits on top of the needle)
+    g.setColour (juce::Colours::white.withAlpha (0.35f));
+    g.fillEllipse (c.x - 5.0f, c.y - 5.0f, 10.0f, 10.0f);
+    g.setColour (juce::Colours::white.withAlpha (0.16f));
+    g.drawEllipse (c.x - 5.0f, c.y - 5.0f, 10.0f, 10.0f, 1.0f);
+}
+
+void BusGovernorAudioProcessorEditor::paint (juce::Graphics& g)
+{
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    if (! staticLayer.isValid() || scale != staticLayerScale)
+        renderStaticLayer (scale);
+
+    g.drawImage (staticLayer, getLocalBounds().toFloat());
+
+    // ---- Spectrum and gain reduction trace ----
+    if (g.clipRegionIntersects (analyzerArea))
+        drawAnalyzer (g);
+
+    // ---- Governor Needle (driven by b) ----
+    if (g.clipRegionIntersects (needleArea))
+    {
+        drawNeedle (g);
+        paintedLamp = lamp;
     }
 }
 
@@ -183,9 +468,43 @@ void BusGovernorAudioProcessorEditor::resized()
 {
     auto bounds = getLocalBounds();
 
-    // Bottom area for knobs
+    // Gauge bounds (top-right), square-ish
+    {
+        auto gauge = bounds.toFloat().removeFromTop (90.0f).removeFromRight (120.0f).reduced (10.0f);
+        float size = juce::jmin (gauge.getWidth(), gauge.getHeight());
+        gaugeBounds = gauge.withSizeKeepingCentre (size, size);
+
+        // Needle + shadow stay within the arc radius around the hub
+        const float r = size * 0.44f;
+        needleArea = juce::Rectangle<float> (r * 2.0f, r * 2.0f)
+                         .withCentre (gaugeBounds.getCentre())
+                         .expanded (4.0f)
+                         .getSmallestIntegerContainer();
+    }
+
+    staticLayer = {};
+    paintedLamp = -1.0f;
+
+    // Under the title
+    cpuLabel.setBounds (bounds.withTrimmedTop (26).withHeight (16).withTrimmedLeft (4).withTrimmedRight (130));
+
+    // Loudness lines under the CPU readout, then the match/reset row
+    inLoudnessLabel .setBounds (bounds.withTrimmedTop (94).withHeight (16).withTrimmedLeft (4).withTrimmedRight (4));
+    outLoudnessLabel.setBounds (bounds.withTrimmedTop (110).withHeight (16).withTrimmedLeft (4).withTrimmedRight (4));
+
+    {
+        auto row = bounds.withTrimmedTop (130).withHeight (20).reduced (8, 0);
+        matchButton.setBounds (row.removeFromLeft (80));
+        loudnessResetButton.setBounds (row.removeFromLeft (56).reduced (0, 1));
+    }
+
+    // Bottom area for knobs, analyzer between it and the match/reset row
     auto bottom = bounds.removeFromBottom (120).reduced (18);
 
+    analyzerArea = bounds.withTrimmedTop (156).reduced (8, 0);
+    updateSpectrumPaths();
+    updateGainReductionPath();
+
     auto knobW = bottom.getWidth() / 3;
 
     pressureSlider.setBounds (bottom.removeFromLeft (knobW).reduced (10, 10));
@@ -26,12 +26,59 @@ public:
 private:
     void timerCallback() override;
 
+    void renderStaticLayer (float scale);
+    void drawNeedle (juce::Graphics&) const;
+    void drawAnalyzer (juce::Graphics&) const;
+
     BusGovernorAudioProcessor& audioProcessor;
 
     // Background + needle smoothing value (still named lamp, but now it drives the needle)
     juce::Image backgroundImage;
     float lamp = 0.0f; // 0..1
 
+    // Background, overlay, title and gauge face, pre-rendered at the display
+    // scale. Cleared by resized() and rebuilt by the next paint().
+    juce::Image staticLayer;
+    float staticLayerScale = 0.0f;
+
+    // Gauge geometry (set in resized) and the needle position last painted
+    juce::Rectangle<float> gaugeBounds;
+    juce::Rectangle<int> needleArea;
+    float paintedLamp = -1.0f;
+
+    // Drained telemetry: peak b since the last frame (held while the host is idle)
+    std::array<BusGovernorAudioProcessor::TelemetryRecord, 64> telemetry;
+    float meterB = 0.0f;
+
+    // processBlock CPU readout, refreshed a few times a second
+    juce::Label cpuLabel;
+    int cpuRefreshCountdown = 0;
+
+    void updateCpuReadout();
+
+    // Input/output loudness readout, refreshed ~10 times a second
+    juce::Label inLoudnessLabel, outLoudnessLabel;
+    int loudnessRefreshCountdown = 0;
+
+    void updateLoudnessReadout();
+
+    // Pre/post spectrum (analysed on the process-wide analysis thread) and a
+    // scrolling gain reduction trace, one point per frame. Paths are rebuilt
+    // only when new data arrives; paint() just fills and strokes them.
+    juce::SharedResourcePointer<BusGovernorAnalysisThread> analysisThread;
+    BusGovernorSpectrumAnalyzer spectrum;
+    BusGovernorSpectrumAnalyzer::Frame spectrumFrame;
+
+    static constexpr int traceLength = 128;       // ~4 s at 30 fps
+    std::array<float, traceLength> gainReductionTrace {};
+    int traceNext = 0;                            // oldest point, next to be overwritten
+
+    juce::Rectangle<int> analyzerArea;
+    juce::Path inputSpectrumPath, outputSpectrumPath, gainReductionPath;
+
+    void updateSpectrumPaths();
+    void updateGainReductionPath();
+
     //==============================================================================
     // Controls
     juce::Slider pressureSlider;
@@ -42,10 +89,16 @@ private:
     juce::Label driveLabel;
     juce::Label volumeLabel;     // (replaces makeup)
 
+    juce::ToggleButton matchButton { "Match" };     // auto volume match
+    juce::TextButton loudnessResetButton { "Reset" };
+
     using SliderAttachment = juce::AudioProcessorValueTreeState::SliderAttachment;
     std::unique_ptr<SliderAttachment> pressureAttachment;
     std::unique_ptr<SliderAttachment> driveAttachment;
     std::unique_ptr<SliderAttachment> volumeAttachment; // (replaces makeup)
 
+    using ButtonAttachment = juce::AudioProcessorValueTreeState::ButtonAttachment;
+    std::unique_ptr<ButtonAttachment> matchAttachment;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BusGovernorAudioProcessorEditor)
 };
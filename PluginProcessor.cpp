@@ -38,6 +38,93 @@ juce::AudioProcessorValueTreeState::ParameterLayout BusGovernorAudioProcessor::c
         juce::NormalisableRange<float> (0.0f, 2.0f, 0.001f),
         1.0f));
 
+    // Eco: evaluate the governor's pow every N samples (see BusGovernorCore)
+    params.push_back (std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID { paramEcoId, 1 },
+        "Eco",
+        juce::StringArray { "Off", "4", "8", "16", "32" },
+        0));
+
+    // Oversampling around the governor (polyphase IIR half-band stages)
+    params.push_back (std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID { paramOversampleId, 1 },
+        "Oversampling",
+        juce::StringArray { "Off", "2x", "4x", "8x" },
+        0));
+
+    // Surround layouts: whether the LFE channel(s) drive the linked detector
+    params.push_back (std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID { paramLfeDetectId, 1 },
+        "LFE in Detector",
+        false));
+
+    // Lookahead: audio is delayed, the detector sees the peak of what's coming.
+    // Not automatable: every change clears the delay line and moves the
+    // latency, which the host only compensates for outside playback.
+    params.push_back (std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID { paramLookaheadId, 1 },
+        "Lookahead",
+        juce::NormalisableRange<float> (0.0f, maxLookaheadMs, 0.1f),
+        0.0f,
+        juce::AudioParameterFloatAttributes().withLabel ("ms").withAutomatable (false)));
+
+    // Multiband mode: one governor per band (mono/stereo layouts only)
+    params.push_back (std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID { paramBandsId, 1 },
+        "Bands",
+        juce::StringArray { "Off", "2", "3", "4" },
+        0));
+
+    // Trims the output so its short-term loudness follows the input's
+    params.push_back (std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID { paramAutoMatchId, 1 },
+        "Auto Volume Match",
+        false));
+
+    // Anticipative processing: one block of extra latency, the work moves
+    // to the shared worker pool (see BusGovernorAnticipation)
+    params.push_back (std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID { paramAnticipateId, 1 },
+        "Anticipative Processing",
+        false));
+
+    const float crossoverRanges[3][3] = { { 40.0f,   1000.0f,  200.0f },    // min, max, default
+                                          { 200.0f,  5000.0f,  1500.0f },
+                                          { 1000.0f, 16000.0f, 6000.0f } };
+
+    for (int k = 0; k < 3; ++k)
+    {
+        juce::NormalisableRange<float> range (crossoverRanges[k][0], crossoverRanges[k][1], 1.0f);
+        range.setSkewForCentre (std::sqrt (crossoverRanges[k][0] * crossoverRanges[k][1]));
+
+        params.push_back (std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID { paramCrossoverIds[k], 1 },
+            "Crossover " + juce::String (k + 1),
+            range,
+            crossoverRanges[k][2],
+            juce::AudioParameterFloatAttributes().withLabel ("Hz")));
+    }
+
+    for (int j = 0; j < 4; ++j)
+    {
+        juce::NormalisableRange<float> driveTrim (0.25f, 4.0f, 0.01f);
+        driveTrim.setSkewForCentre (1.0f);
+
+        params.push_back (std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID { paramBandDriveIds[j], 1 },
+            "Band " + juce::String (j + 1) + " Drive",
+            driveTrim,
+            1.0f,
+            juce::AudioParameterFloatAttributes().withLabel ("x")));
+
+        params.push_back (std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID { paramBandPressureIds[j], 1 },
+            "Band " + juce::String (j + 1) + " Pressure",
+            juce::NormalisableRange<float> (0.0f, 2.0f, 0.01f),
+            1.0f,
+            juce::AudioParameterFloatAttributes().withLabel ("x")));
+    }
+
     return { params.begin(), params.end() };
 }
 
@@ -57,9 +144,83 @@ BusGovernorAudioProcessor::BusGovernorAudioProcessor()
     : apvts (*this, nullptr, "Parameters", createParameterLayout())
 #endif
 {
+    pressureParam   = apvts.getRawParameterValue (paramPressureId);
+    driveParam      = apvts.getRawParameterValue (paramDriveId);
+    volumeParam     = apvts.getRawParameterValue (paramVolumeId);
+    ecoParam        = apvts.getRawParameterValue (paramEcoId);
+    oversampleParam = apvts.getRawParameterValue (paramOversampleId);
+    lfeDetectParam  = apvts.getRawParameterValue (paramLfeDetectId);
+    lookaheadParam  = apvts.getRawParameterValue (paramLookaheadId);
+    bandsParam      = apvts.getRawParameterValue (paramBandsId);
+    autoMatchParam  = apvts.getRawParameterValue (paramAutoMatchId);
+    anticipateParam = apvts.getRawParameterValue (paramAnticipateId);
+
+    for (size_t k = 0; k < crossoverParams.size(); ++k)
+        crossoverParams[k] = apvts.getRawParameterValue (paramCrossoverIds[k]);
+
+    for (size_t j = 0; j < bandDriveParams.size(); ++j)
+    {
+        bandDriveParams[j]    = apvts.getRawParameterValue (paramBandDriveIds[j]);
+        bandPressureParams[j] = apvts.getRawParameterValue (paramBandPressureIds[j]);
+    }
+
+    apvts.addParameterListener (paramAnticipateId, this);
+
+    // Passes latency changes made on the audio thread on to the host
+    startTimerHz (20);
+}
+
+BusGovernorAudioProcessor::~BusGovernorAudioProcessor()
+{
+    stopTimer();
+    apvts.removeParameterListener (paramAnticipateId, this);
+    cancelPendingUpdate();
+
+    // No block may still be in flight on a worker while members go away
+    floatEngine.anticipator.release();
+    doubleEngine.anticipator.release();
+}
+
+//==============================================================================
+// Starts the pool's threads; never on the audio thread
+void BusGovernorAudioProcessor::acquireWorkerPool()
+{
+    const std::lock_guard<std::mutex> lock (workerPoolLock);
+
+    if (workerPoolHolder == nullptr)
+    {
+        workerPoolHolder = std::make_unique<juce::SharedResourcePointer<BusGovernorWorkerPool>>();
+        workerPool.store (&workerPoolHolder->get(), std::memory_order_release);
+    }
+}
+
+// Whichever thread set the parameter; only the message thread creates the pool
+void BusGovernorAudioProcessor::parameterChanged (const juce::String&, float newValue)
+{
+    if (newValue < 0.5f || workerPool.load (std::memory_order_acquire) != nullptr)
+        return;
+
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        acquireWorkerPool();
+    else
+        triggerAsyncUpdate();
 }
 
-BusGovernorAudioProcessor::~BusGovernorAudioProcessor() {}
+void BusGovernorAudioProcessor::handleAsyncUpdate()
+{
+    acquireWorkerPool();
+}
+
+// JUCE notifies the host of a latency change under a lock, and posting a
+// message from the audio thread would lock as well; a poll of the value
+// reportLatency() left needs neither
+void BusGovernorAudioProcessor::timerCallback()
+{
+    const int latency = latencyToReport.load (std::memory_order_relaxed);
+
+    if (latency != getLatencySamples())
+        setLatencySamples (latency);
+}
 
 //==============================================================================
 const juce::String BusGovernorAudioProcessor::getName() const { return JucePlugin_Name; }
@@ -100,16 +261,233 @@ const juce::String BusGovernorAudioProcessor::getProgramName (int) { return {};
 void BusGovernorAudioProcessor::changeProgramName (int, const juce::String&) {}
 
 //==============================================================================
-void BusGovernorAudioProcessor::prepareToPlay (double, int)
+void BusGovernorAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+{
+    floatEngine.anticipator.release();
+    doubleEngine.anticipator.release();
+
+    if (anticipateParam->load() >= 0.5f)
+        acquireWorkerPool();
+
+    currentSampleRate = sampleRate;
+    hostCpuMeter.prepare (sampleRate, samplesPerBlock);
+    cpuMeter.prepare (sampleRate, samplesPerBlock);
+    analyzerTap.prepare (sampleRate);
+
+    pressureSmooth.reset (sampleRate, parameterRampSeconds);
+    driveSmooth   .reset (sampleRate, parameterRampSeconds);
+    volumeSmooth  .reset (sampleRate, parameterRampSeconds);
+
+    pressureSmooth.setCurrentAndTargetValue (pressureParam->load());
+    driveSmooth   .setCurrentAndTargetValue (driveParam->load());
+    volumeSmooth  .setCurrentAndTargetValue (volumeParam->load());
+
+    for (size_t j = 0; j < bandDriveSmooth.size(); ++j)
+    {
+        bandDriveSmooth[j]   .reset (sampleRate, parameterRampSeconds);
+        bandPressureSmooth[j].reset (sampleRate, parameterRampSeconds);
+        bandDriveSmooth[j]   .setCurrentAndTargetValue (bandDriveParams[j]->load());
+        bandPressureSmooth[j].setCurrentAndTargetValue (bandPressureParams[j]->load());
+    }
+
+    for (size_t k = 0; k < crossoverSmooth.size(); ++k)
+    {
+        crossoverSmooth[k].reset (sampleRate, parameterRampSeconds);
+        crossoverSmooth[k].setCurrentAndTargetValue (crossoverParams[k]->load());
+    }
+
+    // LFE channels can be switched in and out of the linked detector per block
+    const auto layout = getChannelLayoutOfBus (false, 0);
+    lfeChannels.clear();
+
+    // BS.1770 weights: LFE out, surrounds +1.5 dB; ambisonics on W only
+    loudness.prepare (sampleRate, getTotalNumOutputChannels(), 2);
+
+    if (layout.getAmbisonicOrder() < 0)
+    {
+        for (int ch = 0; ch < juce::jmin (getTotalNumOutputChannels(), layout.size()); ++ch)
+        {
+            const auto type = layout.getTypeOfChannel (ch);
+
+            if (type == juce::AudioChannelSet::LFE || type == juce::AudioChannelSet::LFE2)
+            {
+                lfeChannels.push_back (ch);
+                loudness.setChannelWeight (ch, 0.0);
+            }
+            else if (type == juce::AudioChannelSet::leftSurround || type == juce::AudioChannelSet::rightSurround
+                  || type == juce::AudioChannelSet::leftSurroundSide || type == juce::AudioChannelSet::rightSurroundSide
+                  || type == juce::AudioChannelSet::leftSurroundRear || type == juce::AudioChannelSet::rightSurroundRear)
+            {
+                loudness.setChannelWeight (ch, 1.41);
+            }
+        }
+    }
+    else
+    {
+        for (int ch = 1; ch < getTotalNumOutputChannels(); ++ch)
+            loudness.setChannelWeight (ch, 0.0);
+    }
+
+    matchGain.reset (sampleRate, matchRampSeconds);
+    matchGain.setCurrentAndTargetValue (1.0f);
+    matchTargetDb = 0.0f;
+    matchGainDb.store (0.0f, std::memory_order_relaxed);
+
+    // Only the precision the host asked for gets its buffers
+    if (isUsingDoublePrecision())
+        prepareEngine (doubleEngine, samplesPerBlock);
+    else
+        prepareEngine (floatEngine, samplesPerBlock);
+
+    // Not the audio thread: the host gets the latency before the first block
+    setLatencySamples (latencyToReport.load (std::memory_order_relaxed));
+}
+
+template <typename SampleType>
+void BusGovernorAudioProcessor::prepareEngine (Engine<SampleType>& engine, int samplesPerBlock)
+{
+    engine.core.reset();
+
+    engine.core.setParameters ({ pressureSmooth.getCurrentValue(),
+                                 driveSmooth.getCurrentValue(),
+                                 volumeSmooth.getCurrentValue() });
+
+    // Linked detector weights: every channel counts once; mono keeps the
+    // original |l + l|; ambisonic stems detect on the omni (W) channel only
+    const auto layout = getChannelLayoutOfBus (false, 0);
+    const int numOutputs = getTotalNumOutputChannels();
+
+    engine.detectorWeights.assign ((size_t) numOutputs, SampleType (layout.size() == 1 ? 2 : 1));
+    engine.channelPointers.assign ((size_t) numOutputs, nullptr);
+
+    if (layout.getAmbisonicOrder() >= 0 && numOutputs > 0)
+    {
+        std::fill (engine.detectorWeights.begin(), engine.detectorWeights.end(), SampleType (0));
+        engine.detectorWeights[0] = SampleType (2);
+    }
+
+    updateDetectorWeights (engine);
+
+    // All factors are built here so switching never allocates on the audio thread
+    const auto numChannels = (size_t) juce::jmax (1, numOutputs);
+
+    for (size_t i = 0; i < engine.oversamplers.size(); ++i)
+    {
+        engine.oversamplers[i] = std::make_unique<juce::dsp::Oversampling<SampleType>> (
+            numChannels, i + 1,
+            juce::dsp::Oversampling<SampleType>::filterHalfBandPolyphaseIIR,
+            true,    // max quality
+            true);   // integer latency, so the host can compensate exactly
+
+        engine.oversamplers[i]->initProcessing ((size_t) samplesPerBlock);
+    }
+
+    // Lookahead runs inside the oversampled section, so size it for 8x.
+    // The detector scratch covers one whole oversampled block.
+    const int maxFactor = 1 << (int) engine.oversamplers.size();
+    const int maxLookahead = (int) std::ceil (maxLookaheadMs * 0.001 * currentSampleRate);
+
+    engine.lookahead.prepare (numOutputs, maxLookahead * maxFactor);
+    engine.detector.assign ((size_t) juce::jmax (1, samplesPerBlock * maxFactor), SampleType (0));
+
+    engine.multiband.prepare (currentSampleRate);
+
+    engine.meterInput.setSize (numOutputs, samplesPerBlock);
+    engine.meterPointers.assign ((size_t) numOutputs * 2, nullptr);
+
+    engine.anticipator.prepare (juce::jmax (getTotalNumInputChannels(), numOutputs), samplesPerBlock,
+                                [this, &engine] (SampleType* const* channels, int numChannels, int numSamples)
+                                {
+                                    const BusGovernorRealtimeGuard::ScopedAudioThread realtimeGuard;
+                                    juce::AudioBuffer<SampleType> block (channels, numChannels, numSamples);
+                                    processSamples (block, engine);
+                                });
+
+    anticipating = workerPool.load (std::memory_order_acquire) != nullptr && anticipateParam->load() >= 0.5f;
+    anticipationActive.store (anticipating, std::memory_order_relaxed);
+
+    currentOversampling = -1;
+    currentLookahead = -1;
+    configureBlock (engine, numOutputs);
+}
+
+// Host thread, with no block in flight: the band count, oversampling and
+// lookahead for the next block, and the latency they add up to
+template <typename SampleType>
+void BusGovernorAudioProcessor::configureBlock (Engine<SampleType>& engine, int numChannels)
 {
-    a = 1.0f;
-    b = 1.0f;
+    const int bands = activeBands (juce::jmin (numChannels, (int) engine.channelPointers.size()));
+    engine.multiband.setNumBands (bands);
 
-    bSmooth = 1.0f;
-    bMeter.store (0.0f, std::memory_order_relaxed);
+    // The bands have no lookahead path
+    updateLatency (engine, (int) oversampleParam->load(), bands > 1 ? 0 : lookaheadSamples());
 }
 
-void BusGovernorAudioProcessor::releaseResources() {}
+int BusGovernorAudioProcessor::lookaheadSamples() const noexcept
+{
+    return juce::roundToInt (lookaheadParam->load() * 0.001 * currentSampleRate);
+}
+
+// 1 = wideband. The bands need a mono or stereo bus.
+int BusGovernorAudioProcessor::activeBands (int numChannels) const noexcept
+{
+    return numChannels <= 2 ? (int) bandsParam->load() + 1 : 1;
+}
+
+// Oversampling filters plus the lookahead delay, both in host samples
+template <typename SampleType>
+void BusGovernorAudioProcessor::updateLatency (Engine<SampleType>& engine, int newOversampling, int newLookahead)
+{
+    if (newOversampling == currentOversampling && newLookahead == currentLookahead)
+        return;
+
+    if (newOversampling != currentOversampling && newOversampling > 0)
+        engine.oversamplers[(size_t) newOversampling - 1]->reset();
+
+    currentOversampling = newOversampling;
+    currentLookahead    = newLookahead;
+
+    // The bands' crossovers run at the oversampled rate
+    engine.multiband.setSampleRate (currentSampleRate * (1 << juce::jmax (0, currentOversampling)));
+
+    engine.lookahead.setLookahead (currentLookahead << juce::jmax (0, currentOversampling));
+
+    dspLatency = currentLookahead;
+
+    if (currentOversampling > 0)
+        dspLatency += (int) engine.oversamplers[(size_t) currentOversampling - 1]->getLatencyInSamples();
+
+    reportLatency();
+}
+
+// Anticipation adds one prepared block on top of the DSP latency. Host
+// thread only, like everything that reads `anticipating`. The host hears
+// of it from timerCallback() (or at the end of prepareToPlay).
+void BusGovernorAudioProcessor::reportLatency()
+{
+    int ahead = 0;
+
+    if (anticipating)
+        ahead = isUsingDoublePrecision() ? doubleEngine.anticipator.getLatency()
+                                         : floatEngine.anticipator.getLatency();
+
+    latencyToReport.store (dspLatency + ahead, std::memory_order_relaxed);
+}
+
+template <typename SampleType>
+void BusGovernorAudioProcessor::updateDetectorWeights (Engine<SampleType>& engine) noexcept
+{
+    const auto lfeWeight = SampleType (lfeDetectParam->load() >= 0.5f ? 1 : 0);
+
+    for (auto ch : lfeChannels)
+        engine.detectorWeights[(size_t) ch] = lfeWeight;
+}
+
+void BusGovernorAudioProcessor::releaseResources()
+{
+    floatEngine.anticipator.release();
+    doubleEngine.anticipator.release();
+}
 
 #ifndef JucePlugin_PreferredChannelConfigurations
 bool BusGovernorAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
@@ -118,8 +496,8 @@ bool BusGovernorAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
     juce::ignoreUnused (layouts);
     return true;
   #else
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any channel set: above stereo the channels share one linked detector
+    if (layouts.getMainOutputChannelSet().isDisabled())
         return false;
 
    #if ! JucePlugin_IsSynth
@@ -134,74 +512,256 @@ bool BusGovernorAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
 
 void BusGovernorAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
 {
+    processOrAnticipate (buffer, floatEngine);
+}
+
+void BusGovernorAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer&)
+{
+    processOrAnticipate (buffer, doubleEngine);
+}
+
+// Switching anticipation drops the block in flight and restarts the FIFO
+// from silence: a one-off gap, at the moment the latency changes anyway
+template <typename SampleType>
+void BusGovernorAudioProcessor::processOrAnticipate (juce::AudioBuffer<SampleType>& buffer, Engine<SampleType>& engine)
+{
+    const BusGovernorRealtimeGuard::ScopedAudioThread realtimeGuard;   // test builds only
+    const BusGovernorCpuMeter::ScopedTimer cpuTimer (hostCpuMeter, buffer.getNumSamples());
+
+    auto& anticipator = engine.anticipator;
+    auto* pool = workerPool.load (std::memory_order_acquire);
+
+    // Until the pool is up the parameter has no effect yet
+    const bool wanted = pool != nullptr && anticipateParam->load() >= 0.5f;
+
+    if (wanted != anticipating)
+    {
+        anticipator.reset();
+        anticipating = wanted;
+        anticipationActive.store (wanted, std::memory_order_relaxed);
+        reportLatency();
+    }
+
+    // Anything that moves the latency is settled here, with no block in
+    // flight, so the block itself (possibly on a worker) only runs DSP
+    if (anticipating)
+        anticipator.finish();
+
+    configureBlock (engine, buffer.getNumChannels());
+
+    if (anticipating && buffer.getNumChannels() == anticipator.getNumChannels())
+        anticipator.process (*pool, buffer.getArrayOfWritePointers(), buffer.getNumSamples());
+    else
+        processSamples (buffer, engine);
+}
+
+template <typename SampleType>
+void BusGovernorAudioProcessor::processSamples (juce::AudioBuffer<SampleType>& buffer, Engine<SampleType>& engine)
+{
+    const BusGovernorCpuMeter::ScopedTimer cpuTimer (cpuMeter, buffer.getNumSamples());
     juce::ScopedNoDenormals noDenormals;
 
+    auto& core = engine.core;
+
     const int numSamples  = buffer.getNumSamples();
     const int numChannels = buffer.getNumChannels();
+    const int numProcessed = juce::jmin (numChannels, (int) engine.channelPointers.size());
+
+    // Read params once per block; the core ramps to where the smoothers
+    // land at the end of this block (no-op when nothing is moving)
+    pressureSmooth.setTargetValue (pressureParam->load());
+    driveSmooth   .setTargetValue (driveParam->load());
+    volumeSmooth  .setTargetValue (volumeParam->load());
+
+    const BusGovernorParameters target { pressureSmooth.skip (numSamples),
+                                         driveSmooth.skip (numSamples),
+                                         volumeSmooth.skip (numSamples) };
+    core.setTargetParameters (target);
 
-    float* ch0 = buffer.getWritePointer (0);
-    float* ch1 = (numChannels > 1) ? buffer.getWritePointer (1) : nullptr;
+    const int eco = (int) ecoParam->load();
+    core.setControlInterval (eco > 0 ? (2 << eco) : 1);   // 0 -> 1, 1..4 -> 4..32
 
-    // Read params once per block
-    const float pressure = apvts.getRawParameterValue (paramPressureId)->load();
-    const float drive    = apvts.getRawParameterValue (paramDriveId)->load();
-    const float volume   = apvts.getRawParameterValue (paramVolumeId)->load();
+    // Multiband: crossovers and band trims ramp like the wideband parameters
+    // (their smoothers run while the bands are off, so switching on starts
+    // from the current settings). configureBlock set the band count.
+    auto& multiband = engine.multiband;
+    const int bands = multiband.getNumBands();
 
-    constexpr float eps = 1.0e-12f;
-    constexpr float shapeK = 6.0f;
+    for (size_t k = 0; k < crossoverSmooth.size(); ++k)
+    {
+        crossoverSmooth[k].setTargetValue (crossoverParams[k]->load());
+        multiband.setTargetCrossover ((int) k, crossoverSmooth[k].skip (numSamples));
+    }
 
-    for (int s = 0; s < numSamples; ++s)
+    for (size_t j = 0; j < bandDriveSmooth.size(); ++j)
     {
-        const float l = ch0[s];
-        const float r = (ch1 != nullptr) ? ch1[s] : l;
+        bandDriveSmooth[j]   .setTargetValue (bandDriveParams[j]->load());
+        bandPressureSmooth[j].setTargetValue (bandPressureParams[j]->load());
 
-        // Detector from INPUT only
-        const float det = std::abs (l + r);
+        const float driveTrim    = bandDriveSmooth[j].skip (numSamples);
+        const float pressureTrim = bandPressureSmooth[j].skip (numSamples);
 
-        // ---- BusGovernor core ----
-        const float aSafe = std::max (a, eps);
-        a = (1.0f - 0.012f) * (a + std::abs (b - a))
-          + 0.012f * std::abs (b * det * det * drive) / (aSafe * aSafe);
+        multiband.setBandTargetParameters ((int) j, { juce::jlimit (0.0f, 1.0f,  target.pressure * pressureTrim),
+                                                      juce::jlimit (1.0f, 24.0f, target.drive * driveTrim),
+                                                      target.volume });
+    }
 
-        const float bSafe = std::max (b, eps);
-        const float base  = std::max (b + std::abs (a - b), eps);
-        const float expo  = a / bSafe;
-        b = (1.0f - 0.008f) * (a + std::abs (b - a))
-          + 0.008f * std::abs (std::pow (base, expo));
+    updateDetectorWeights (engine);
 
-        // ---- Base output: NO makeup inside ----
-        const float invb = 1.0f / std::max (b, eps);
-        float outL = l * invb;   // out = in/b
-        float outR = r * invb;
+    TelemetryRecord telemetry;
+    telemetry.inputPeak = (float) buffer.getMagnitude (0, numSamples);
 
-        // ---- Pressure A: shaped delta between out and out/b ----
-        const float pressedL = outL * invb;   // out/b
-        const float pressedR = outR * invb;
+    analyzerTap.push (BusGovernorAnalyzerTap::input, buffer.getArrayOfReadPointers(), numProcessed, numSamples);
 
-        const float dL = pressedL - outL;
-        const float dR = pressedR - outR;
+    // Allocates only if the host exceeds the block size it prepared with
+    const bool metering = numProcessed == loudness.getNumChannels();
 
-        const float dLs = dL / (1.0f + shapeK * std::abs (dL));
-        const float dRs = dR / (1.0f + shapeK * std::abs (dR));
+    if (metering)
+    {
+        engine.meterInput.setSize (numProcessed, numSamples, false, false, true);
+
+        for (int ch = 0; ch < numProcessed; ++ch)
+            engine.meterInput.copyFrom (ch, 0, buffer, ch, 0, numSamples);
+    }
+
+    if (currentOversampling > 0)
+    {
+        // The governor runs at the oversampled rate (same as running the
+        // session at that rate: its smoothing is per sample)
+        juce::dsp::AudioBlock<SampleType> block (buffer);
+        auto io = block.getSubsetChannelBlock (0, (size_t) numProcessed);
 
-        outL += pressure * dLs;
-        outR += pressure * dRs;
+        auto& os = *engine.oversamplers[(size_t) currentOversampling - 1];
+        auto up = os.processSamplesUp (io);
 
-        // ---- Post output Volume (pure trim) ----
-        outL *= volume;
-        outR *= volume;
+        for (int ch = 0; ch < numProcessed; ++ch)
+            engine.channelPointers[(size_t) ch] = up.getChannelPointer ((size_t) ch);
 
-        ch0[s] = outL;
-        if (ch1 != nullptr)
-            ch1[s] = outR;
+        runCore (engine, numProcessed, (int) up.getNumSamples());
 
-        // ---- UI meter (smoothed) ----
-        bSmooth = 0.95f * bSmooth + 0.05f * b;
-        bMeter.store (bSmooth, std::memory_order_relaxed);
+        os.processSamplesDown (io);
+    }
+    else
+    {
+        for (int ch = 0; ch < numProcessed; ++ch)
+            engine.channelPointers[(size_t) ch] = buffer.getWritePointer (ch);
+
+        runCore (engine, numProcessed, numSamples);
     }
 
-    for (int ch = 2; ch < numChannels; ++ch)
+    for (int ch = numProcessed; ch < numChannels; ++ch)
         buffer.clear (ch, 0, numSamples);
+
+    // ---- Loudness: input and output in one pass, then the match trim ----
+    if (metering)
+    {
+        for (int ch = 0; ch < numProcessed; ++ch)
+        {
+            engine.meterPointers[(size_t) ch] = engine.meterInput.getReadPointer (ch);
+            engine.meterPointers[(size_t) (numProcessed + ch)] = buffer.getReadPointer (ch);
+        }
+
+        loudness.process (engine.meterPointers.data(), numSamples);
+    }
+
+    applyMatchGain (buffer, numProcessed, numSamples);
+
+    analyzerTap.push (BusGovernorAnalyzerTap::output, buffer.getArrayOfReadPointers(), numProcessed, numSamples);
+
+    // ---- UI telemetry (one record per block) ----
+    const auto stats = bands > 1 ? multiband.getBlockStats() : core.getBlockStats();
+
+    telemetry.minB  = stats.minB;
+    telemetry.maxB  = stats.maxB;
+    telemetry.meanB = stats.meanB;
+    telemetry.outputPeak = (float) buffer.getMagnitude (0, numSamples);
+    telemetry.gainReductionDb = 20.0f * std::log10 (juce::jmax (stats.maxB, BusGovernorCore::eps));
+    telemetry.sleepFraction = stats.sleepFraction;
+
+    pushTelemetry (telemetry);
+}
+
+// Mono/stereo keep the dedicated |l + l| / |l + r| kernels; wider layouts
+// share one linked detector weighted by detectorWeights. With lookahead on,
+// every layout takes the delayed path with the windowed linked detector.
+// Multiband mode (mono/stereo, no lookahead) replaces all of these.
+template <typename SampleType>
+void BusGovernorAudioProcessor::runCore (Engine<SampleType>& engine, int numChannels, int numSamples) noexcept
+{
+    auto& ptrs = engine.channelPointers;
+
+    if (engine.multiband.getNumBands() > 1 && numChannels > 0)
+        engine.multiband.process (ptrs[0], numChannels > 1 ? ptrs[1] : nullptr, numSamples);
+    else if (engine.lookahead.getLookahead() > 0 && numChannels > 0)
+    {
+        const int maxChunk = (int) engine.detector.size();
+        auto* det = engine.detector.data();
+
+        for (int start = 0; start < numSamples; start += maxChunk)
+        {
+            const int n = juce::jmin (maxChunk, numSamples - start);
+
+            engine.lookahead.process (ptrs.data(), engine.detectorWeights.data(), numChannels, det, n);
+            engine.core.process (ptrs.data(), numChannels, det, n);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                ptrs[(size_t) ch] += n;
+        }
+    }
+    else if (numChannels > 2)
+        engine.core.process (ptrs.data(), engine.detectorWeights.data(), numChannels, numSamples);
+    else if (numChannels > 0)
+        engine.core.process (ptrs[0], numChannels > 1 ? ptrs[1] : nullptr, numSamples);
+}
+
+// Off: glides back to unity. On: follows the input/output short-term
+// difference, holding the last trim while either side is below the gate.
+template <typename SampleType>
+void BusGovernorAudioProcessor::applyMatchGain (juce::AudioBuffer<SampleType>& buffer, int numChannels, int numSamples) noexcept
+{
+    if (autoMatchParam->load() >= 0.5f)
+    {
+        const auto in  = loudness.getReadout (0);
+        const auto out = loudness.getReadout (1);
+
+        if (in.shortTerm > BusGovernorLoudness::absoluteGate && out.shortTerm > BusGovernorLoudness::absoluteGate)
+            matchTargetDb = juce::jlimit (-maxMatchDb, maxMatchDb, in.shortTerm - out.shortTerm);
+    }
+    else
+    {
+        matchTargetDb = 0.0f;
+    }
+
+    matchGain.setTargetValue (juce::Decibels::decibelsToGain (matchTargetDb));
+
+    const float start = matchGain.getCurrentValue();
+    const float end   = matchGain.skip (numSamples);
+
+    matchGainDb.store (juce::Decibels::gainToDecibels (end), std::memory_order_relaxed);
+
+    if (start == 1.0f && end == 1.0f)
+        return;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        buffer.applyGainRamp (ch, 0, numSamples, (SampleType) start, (SampleType) end);
+}
+
+void BusGovernorAudioProcessor::pushTelemetry (const TelemetryRecord& record) noexcept
+{
+    const auto scope = telemetryFifo.write (1);
+
+    if (scope.blockSize1 > 0)
+        telemetryRecords[(size_t) scope.startIndex1] = record;
+}
+
+int BusGovernorAudioProcessor::popTelemetry (TelemetryRecord* dest, int maxRecords)
+{
+    const auto scope = telemetryFifo.read (maxRecords);
+
+    std::copy_n (telemetryRecords.begin() + scope.startIndex1, scope.blockSize1, dest);
+    std::copy_n (telemetryRecords.begin() + scope.startIndex2, scope.blockSize2, dest + scope.blockSize1);
+
+    return scope.blockSize1 + scope.blockSize2;
 }
 
 //==============================================================================
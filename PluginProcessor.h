@@ -9,16 +9,45 @@
 #pragma once
 
 #include <atomic>        // MUST be before JuceHeader on MSVC
+#include <mutex>
 #include <JuceHeader.h>
 
+#include "BusGovernorAnalyzer.h"
+#include "BusGovernorAnticipation.h"
+#include "BusGovernorCore.h"
+#include "BusGovernorCpuMeter.h"
+#include "BusGovernorLookahead.h"
+#include "BusGovernorLoudness.h"
+#include "BusGovernorMultiband.h"
+#include "BusGovernorRealtimeGuard.h"
+
 //==============================================================================
-class BusGovernorAudioProcessor  : public juce::AudioProcessor
+class BusGovernorAudioProcessor  : public juce::AudioProcessor,
+                                   private juce::AudioProcessorValueTreeState::Listener,
+                                   private juce::AsyncUpdater,
+                                   private juce::Timer
 {
 public:
     // Parameter IDs (keep these stable for preset compatibility)
-    static constexpr const char* paramPressureId = "pressure";
-    static constexpr const char* paramDriveId    = "drive";
-    static constexpr const char* paramVolumeId   = "volume";   // (replaces makeup)
+    static constexpr const char* paramPressureId   = "pressure";
+    static constexpr const char* paramDriveId      = "drive";
+    static constexpr const char* paramVolumeId     = "volume";     // (replaces makeup)
+    static constexpr const char* paramEcoId        = "eco";        // control-rate pow (Off/4/8/16/32)
+    static constexpr const char* paramOversampleId = "oversample"; // Off/2x/4x/8x
+    static constexpr const char* paramLfeDetectId  = "lfedetect";  // LFE feeds the linked detector
+    static constexpr const char* paramLookaheadId  = "lookahead";  // 0..maxLookaheadMs
+    static constexpr const char* paramBandsId      = "bands";      // Off/2/3/4 (multiband mode)
+    static constexpr const char* paramAutoMatchId  = "automatch";  // output follows input loudness
+    static constexpr const char* paramAnticipateId = "anticipate"; // process one block ahead on the shared pool
+
+    // Multiband: crossover k sits between band k and band k + 1; the band
+    // trims scale the global drive and pressure for that band
+    static constexpr const char* paramCrossoverIds[]    = { "xover1", "xover2", "xover3" };
+    static constexpr const char* paramBandDriveIds[]    = { "band1drive", "band2drive", "band3drive", "band4drive" };
+    static constexpr const char* paramBandPressureIds[] = { "band1pressure", "band2pressure", "band3pressure", "band4pressure" };
+
+    static constexpr float maxLookaheadMs = 10.0f;
+    static constexpr float maxMatchDb = 24.0f;      // auto volume match range, either way
 
     //==============================================================================
     BusGovernorAudioProcessor();
@@ -33,6 +62,10 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+
+    // 64-bit hosts run the whole chain (core and oversampling) in double
+    bool supportsDoublePrecisionProcessing() const override     { return true; }
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -62,18 +95,176 @@ public:
     juce::AudioProcessorValueTreeState apvts;
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
+    // Ramp time for pressure/drive/volume changes. Takes effect at the next
+    // prepareToPlay.
+    void setParameterRampTime (double seconds)   { parameterRampSeconds = seconds; }
+
     //==============================================================================
-    // Meter exposed to editor (needle)
-    std::atomic<float> bMeter { 0.0f };
+    // Meter telemetry: one record per processBlock, pushed into a wait-free
+    // single-producer/single-consumer ring. Records are dropped while the ring
+    // is full (e.g. no editor open).
+    struct TelemetryRecord
+    {
+        float minB = 1.0f, maxB = 1.0f, meanB = 1.0f;
+        float inputPeak  = 0.0f;        // linear, all channels
+        float outputPeak = 0.0f;
+        float gainReductionDb = 0.0f;   // peak 1/b attenuation, before shaper and volume
+        float sleepFraction = 0.0f;     // share of samples on the core's silence fast path
+    };
+
+    // Message thread only. Copies up to maxRecords of the oldest records into
+    // dest and returns how many were copied.
+    int popTelemetry (TelemetryRecord* dest, int maxRecords);
+
+    // Block timing (see BusGovernorCpuMeter). getHostCpuStats() times all
+    // of processBlock on the host thread, the part the host's deadline sees;
+    // getCpuStats() times the DSP (processSamples) wherever it runs, which in
+    // anticipative mode is a pool worker. Inline the two differ only by the
+    // block setup. Any thread; the reset takes effect at the next block. All
+    // zeros when BUSGOVERNOR_CPU_METER=0.
+    BusGovernorCpuMeter::Stats getHostCpuStats() const noexcept    { return hostCpuMeter.getStats(); }
+    BusGovernorCpuMeter::Stats getCpuStats() const noexcept        { return cpuMeter.getStats(); }
+    void resetCpuStats() noexcept                                   { hostCpuMeter.requestReset(); cpuMeter.requestReset(); }
+
+    // Whether the last block ran anticipatively. Any thread.
+    bool isAnticipating() const noexcept        { return anticipationActive.load (std::memory_order_relaxed); }
+
+    // BS.1770 loudness of the input and of the output (after volume, before
+    // the auto match gain, so it shows what the governor does). Any thread;
+    // the reset restarts both integrated values at the next block.
+    BusGovernorLoudness::Readout getInputLoudness() const noexcept    { return loudness.getReadout (0); }
+    BusGovernorLoudness::Readout getOutputLoudness() const noexcept   { return loudness.getReadout (1); }
+    void resetLoudness() noexcept                                      { loudness.requestReset(); }
+
+    // Input and output samples for the editor's spectrum analyzer; costs
+    // one relaxed load per block while no analyzer is attached
+    BusGovernorAnalyzerTap& getAnalyzerTap() noexcept           { return analyzerTap; }
+
+    // Gain the auto volume match currently applies (0 dB when off)
+    float getMatchGainDb() const noexcept       { return matchGainDb.load (std::memory_order_relaxed); }
+
+    // Anticipative mode counters for the prepared precision. Any thread.
+    BusGovernorAnticipatorT<float>::Stats getAnticipationStats() const noexcept
+    {
+        const auto s = isUsingDoublePrecision() ? doubleEngine.anticipator.getStats() : floatEngine.anticipator.getStats();
+        return { s.blocks, s.fallbacks, s.waits };
+    }
 
 private:
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BusGovernorAudioProcessor)
 
-    // DSP state
-    float a = 1.0f;
-    float b = 1.0f;
+    // Raw parameter values, looked up once at construction
+    std::atomic<float>* pressureParam   = nullptr;
+    std::atomic<float>* driveParam      = nullptr;
+    std::atomic<float>* volumeParam     = nullptr;
+    std::atomic<float>* ecoParam        = nullptr;
+    std::atomic<float>* oversampleParam = nullptr;
+    std::atomic<float>* lfeDetectParam  = nullptr;
+    std::atomic<float>* lookaheadParam  = nullptr;
+    std::atomic<float>* bandsParam      = nullptr;
+    std::atomic<float>* autoMatchParam  = nullptr;
+    std::atomic<float>* anticipateParam = nullptr;
+
+    std::array<std::atomic<float>*, 3> crossoverParams {};
+    std::array<std::atomic<float>*, 4> bandDriveParams {}, bandPressureParams {};
+
+    // Per-block parameter ramps (the core interpolates per sample)
+    double parameterRampSeconds = 0.02;
+    juce::SmoothedValue<float> pressureSmooth, driveSmooth, volumeSmooth;
+
+    // Multiband: the same ramps for the band trims (per sample in the bank)
+    // and the crossovers (geometric, stepped inside the multiband engine)
+    std::array<juce::SmoothedValue<float>, 4> bandDriveSmooth, bandPressureSmooth;
+    std::array<juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative>, 3> crossoverSmooth;
+
+    // DSP for one sample type: the core (a/b state, pressure shaper, volume
+    // trim), its oversamplers and the linked detector. Only the engine for
+    // the host's processing precision is prepared.
+    template <typename SampleType>
+    struct Engine
+    {
+        BusGovernorCoreT<BusGovernorPow, SampleType> core;
+
+        // Oversampling around the governor: index 0..2 -> 2x/4x/8x
+        std::array<std::unique_ptr<juce::dsp::Oversampling<SampleType>>, 3> oversamplers;
+
+        std::vector<SampleType> detectorWeights;
+        std::vector<SampleType*> channelPointers;
+
+        // Delay + windowed peak detector, and its per-block output
+        BusGovernorLookaheadT<SampleType> lookahead;
+        std::vector<SampleType> detector;
+
+        // Multiband mode (mono/stereo): bands in lanes, same pow as the core
+        BusGovernorMultibandT<BusGovernorPow, SampleType> multiband;
+
+        // The block's input, kept so the loudness meter can filter it
+        // alongside the output in one pass
+        juce::AudioBuffer<SampleType> meterInput;
+        std::vector<const SampleType*> meterPointers;
+
+        // Anticipative mode: the whole of processSamples, one block ahead.
+        // Last, so it is gone before anything its blocks touch.
+        BusGovernorAnticipatorT<SampleType> anticipator;
+    };
+
+    // Shared by every instance in the process and started the first time
+    // this one anticipates, never from the audio thread: prepareToPlay, or
+    // the message thread once the parameter turns on. The audio thread only
+    // loads the pointer and processes inline until it is set. Outlives the
+    // engines.
+    std::unique_ptr<juce::SharedResourcePointer<BusGovernorWorkerPool>> workerPoolHolder;
+    std::atomic<BusGovernorWorkerPool*> workerPool { nullptr };
+    std::mutex workerPoolLock;
+
+    void acquireWorkerPool();
+    void parameterChanged (const juce::String& parameterID, float newValue) override;
+    void handleAsyncUpdate() override;
+    void timerCallback() override;
+
+    Engine<float>  floatEngine;
+    Engine<double> doubleEngine;
+
+    double currentSampleRate = 44100.0;
+    int currentOversampling = 0;   // 0 = off, else log2 of the factor
+    int currentLookahead = 0;      // in host samples
+    int dspLatency = 0;            // oversampling + lookahead, without anticipation
+    std::atomic<int> latencyToReport { 0 };   // set on the host thread, reported on the message thread
+    bool anticipating = false;     // host thread only
+    std::atomic<bool> anticipationActive { false };   // its copy for other threads
+    std::vector<int> lfeChannels;  // channels whose weight follows the LFE parameter
+
+    template <typename SampleType> void prepareEngine (Engine<SampleType>&, int samplesPerBlock);
+    template <typename SampleType> void processOrAnticipate (juce::AudioBuffer<SampleType>&, Engine<SampleType>&);
+    template <typename SampleType> void configureBlock (Engine<SampleType>&, int numChannels);
+    template <typename SampleType> void processSamples (juce::AudioBuffer<SampleType>&, Engine<SampleType>&);
+    template <typename SampleType> void runCore (Engine<SampleType>&, int numChannels, int numSamples) noexcept;
+    template <typename SampleType> void updateLatency (Engine<SampleType>&, int newOversampling, int newLookahead);
+    template <typename SampleType> void updateDetectorWeights (Engine<SampleType>&) noexcept;
+    template <typename SampleType> void applyMatchGain (juce::AudioBuffer<SampleType>&, int numChannels, int numSamples) noexcept;
+
+    int lookaheadSamples() const noexcept;
+    void reportLatency();
+    int activeBands (int numChannels) const noexcept;
+
+    // Telemetry ring (audio thread writes, editor reads)
+    static constexpr int telemetryCapacity = 256;
+    juce::AbstractFifo telemetryFifo { telemetryCapacity };
+    std::array<TelemetryRecord, telemetryCapacity> telemetryRecords;
+
+    void pushTelemetry (const TelemetryRecord& record) noexcept;
+
+    BusGovernorCpuMeter hostCpuMeter, cpuMeter;   // processBlock, processSamples
+
+    // Programme 0 = input, 1 = output
+    BusGovernorLoudness loudness;
+
+    BusGovernorAnalyzerTap analyzerTap;
 
-    // UI smoothing for meter
-    float bSmooth = 1.0f;
+    // Auto volume match: output trim towards input short-term loudness
+    static constexpr double matchRampSeconds = 0.1;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> matchGain;
+    float matchTargetDb = 0.0f;
+    std::atomic<float> matchGainDb { 0.0f };
 };
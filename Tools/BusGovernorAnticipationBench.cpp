@@ -0,0 +1,207 @@
+/*
+  ==============================================================================
+
+    BusGovernorAnticipationBench - multicore scaling of anticipative mode.
+
+    Simulates a dense session: hundreds of stereo instances (the wideband
+    core on pink noise) split across a few host audio threads, as a host
+    does. Each host thread runs its instances' blocks one period after the
+    other, unpaced, so it measures capacity:
+
+        inline      every instance processes on its host thread
+        ahead       every instance runs through BusGovernorAnticipatorT on
+                    one shared BusGovernorWorkerPool, one block ahead
+
+    and reports per mode:
+
+        realtime    audio seconds per wall second for the whole session;
+                    at 1.0x or more the session keeps up in real time
+        fallbacks   blocks no worker had started in time (run inline)
+        waits       blocks a worker was still processing when needed
+
+    On an N-core machine inline tops out at the host thread count, ahead
+    at about N. No JUCE needed; from the repository root:
+
+        c++ -O3 -std=c++17 -pthread -o BusGovernorAnticipationBench Tools/BusGovernorAnticipationBench.cpp
+
+    Options:
+
+        --instances <n,...>  instance counts to run (default 64,256,512)
+        --hosts <n>          host audio threads (default 2)
+        --workers <n>        pool threads (default cores - 1)
+        --block <n>          samples per block (default 128)
+        --seconds <s>        audio per instance and mode (default 2)
+
+  ==============================================================================
+*/
+
+#include "../BusGovernorAnticipation.h"
+#include "../BusGovernorCore.h"
+#include "BusGovernorStimuli.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+//==============================================================================
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+
+    struct Instance
+    {
+        BusGovernorCore core;
+        BusGovernorAnticipatorT<float> ahead;
+
+        std::vector<float> left, right;
+        float* io[2] = {};
+        int offset = 0;   // start in the stimulus, so instances differ
+    };
+
+    struct Outcome
+    {
+        double realtime = 0.0;
+        double fallbacks = 0.0, waits = 0.0;   // share of blocks
+    };
+
+    Outcome run (std::vector<std::unique_ptr<Instance>>& instances, BusGovernorWorkerPool* pool,
+                 const std::vector<std::vector<float>>& source, int numHosts, int blockSize, int numBlocks)
+    {
+        for (auto& inst : instances)
+        {
+            inst->core.reset();
+            inst->ahead.reset();
+        }
+
+        const int sourceLength = (int) source[0].size();
+
+        auto host = [&] (int h)
+        {
+            for (int b = 0; b < numBlocks; ++b)
+            {
+                for (size_t i = (size_t) h; i < instances.size(); i += (size_t) numHosts)
+                {
+                    auto& inst = *instances[i];
+                    const int pos = (inst.offset + b * blockSize) % (sourceLength - blockSize);
+
+                    std::copy_n (source[0].data() + pos, blockSize, inst.io[0]);
+                    std::copy_n (source[1].data() + pos, blockSize, inst.io[1]);
+
+                    if (pool != nullptr)
+                        inst.ahead.process (*pool, inst.io, blockSize);
+                    else
+                        inst.core.process (inst.io[0], inst.io[1], blockSize);
+                }
+            }
+        };
+
+        const auto t0 = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> hosts;
+
+        for (int h = 0; h < numHosts; ++h)
+            hosts.emplace_back (host, h);
+
+        for (auto& t : hosts)
+            t.join();
+
+        const double wall = std::chrono::duration<double> (std::chrono::steady_clock::now() - t0).count();
+
+        Outcome o;
+        o.realtime = numBlocks * blockSize / sampleRate / wall;
+
+        if (pool != nullptr)
+        {
+            std::uint64_t blocks = 0, fallbacks = 0, waits = 0;
+
+            for (auto& inst : instances)
+            {
+                const auto s = inst->ahead.getStats();
+                blocks += s.blocks;
+                fallbacks += s.fallbacks;
+                waits += s.waits;
+            }
+
+            o.fallbacks = (double) fallbacks / (double) std::max<std::uint64_t> (1, blocks);
+            o.waits     = (double) waits / (double) std::max<std::uint64_t> (1, blocks);
+        }
+
+        return o;
+    }
+}
+
+//==============================================================================
+int main (int argc, char** argv)
+{
+    std::vector<int> counts { 64, 256, 512 };
+    int numHosts = 2, numWorkers = BusGovernorWorkerPool::getDefaultNumWorkers(), blockSize = 128;
+    double seconds = 2.0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--instances" && hasValue)
+        {
+            counts.clear();
+            std::stringstream list (argv[++i]);
+
+            for (std::string item; std::getline (list, item, ',');)
+                counts.push_back (std::max (1, std::atoi (item.c_str())));
+        }
+        else if (arg == "--hosts" && hasValue)      numHosts = std::max (1, std::atoi (argv[++i]));
+        else if (arg == "--workers" && hasValue)    numWorkers = std::max (1, std::atoi (argv[++i]));
+        else if (arg == "--block" && hasValue)      blockSize = std::max (16, std::atoi (argv[++i]));
+        else if (arg == "--seconds" && hasValue)    seconds = std::atof (argv[++i]);
+        else
+        {
+            std::fprintf (stderr, "usage: %s [--instances n,...] [--hosts n] [--workers n] [--block n] [--seconds s]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    const int numBlocks = std::max (1, (int) (seconds * sampleRate / blockSize));
+    const auto source = BusGovernorStimuli::make (BusGovernorStimuli::Stimulus::pink, 2, sampleRate, (int) (4 * sampleRate));
+
+    BusGovernorWorkerPool pool (numWorkers);
+
+    std::printf ("%u cores, %d host threads, %d workers, %d-sample blocks at %d Hz\n\n",
+                 std::thread::hardware_concurrency(), numHosts, pool.getNumWorkers(), blockSize, (int) sampleRate);
+    std::printf ("%-10s %14s %14s %9s %11s %9s\n", "instances", "inline", "ahead", "speedup", "fallbacks", "waits");
+
+    for (const int count : counts)
+    {
+        std::vector<std::unique_ptr<Instance>> instances;
+
+        for (int i = 0; i < count; ++i)
+        {
+            auto inst = std::make_unique<Instance>();
+            inst->left.assign ((size_t) blockSize, 0.0f);
+            inst->right.assign ((size_t) blockSize, 0.0f);
+            inst->io[0] = inst->left.data();
+            inst->io[1] = inst->right.data();
+            inst->offset = (int) ((i * 7919LL * blockSize) % (long long) (source[0].size() / 2));
+
+            auto* core = &inst->core;
+            inst->ahead.prepare (2, blockSize, [core] (float* const* ch, int, int n) { core->process (ch[0], ch[1], n); });
+
+            instances.push_back (std::move (inst));
+        }
+
+        const auto inlineRun = run (instances, nullptr, source, numHosts, blockSize, numBlocks);
+        const auto aheadRun  = run (instances, &pool, source, numHosts, blockSize, numBlocks);
+
+        std::printf ("%-10d %13.2fx %13.2fx %8.2fx %10.1f%% %8.1f%%\n", count,
+                     inlineRun.realtime, aheadRun.realtime, aheadRun.realtime / inlineRun.realtime,
+                     100.0 * aheadRun.fallbacks, 100.0 * aheadRun.waits);
+    }
+
+    return 0;
+}
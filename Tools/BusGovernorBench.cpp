@@ -0,0 +1,759 @@
+/*
+  ==============================================================================
+
+    BusGovernorBench - reproducible benchmark for the governor DSP path.
+
+    Drives BusGovernorCore (the code processBlock runs) over a matrix of
+    block sizes, channel counts, sample rates, stimuli and drive/pressure
+    settings, then the paths around it: each pow engine, the kernels off
+    their common path, eco intervals, the core alone at 2-8x the host rate
+    ("/rateNx": the governor's share of oversampling, without JUCE's
+    half-band filters), surround layouts on the linked detector, double
+    precision, lookahead, waking from sleep, BusGovernorMultiband by band
+    count (and the same bands without crossovers, "lanes", for the
+    per-stage split) and N independent buses as one BusGovernorBank against
+    N scalar cores. Reports per case
+    (per host sample frame, and per bus for the bus cases):
+
+        nsPerSample       wall time per sample frame (median of the runs)
+        cyclesPerSample   TSC reference cycles per frame (x86 only, else 0)
+        instancesPerCore  how many instances one core sustains in real time
+
+    No JUCE needed; from the repository root:
+
+        c++ -O3 -std=c++17 -o BusGovernorBench Tools/BusGovernorBench.cpp
+
+    Options:
+
+        --quick              reduced matrix (for CI smoke runs)
+        --error-sweep        fast pow error against double pow on the grid
+                             BusGovernorMath.h documents (and on the range
+                             the recurrence reaches), plus ns per call of
+                             both engines; runs nothing else
+        --json <file>        write the results as JSON
+        --baseline <file>    compare against an earlier --json file
+        --tolerance <x>      allowed slowdown vs baseline (default 0.10)
+        --seconds <s>        audio per case and run (default 1)
+        --runs <n>           timed runs per case (default 5)
+
+    Each case resets its processor once and runs 2 s of its stimulus
+    untimed first, so silence is timed on the core's sleep path; the runs
+    then carry the state on. The "wake" cases instead put the core to sleep
+    on silence before every run and time the stimulus coming back.
+
+    Exits with 1 if any case is slower than baseline * (1 + tolerance).
+    All stimuli use fixed seeds, so runs are comparable between machines
+    only through the baseline each machine records for itself.
+
+  ==============================================================================
+*/
+
+#include "../BusGovernorCore.h"
+#include "../BusGovernorLookahead.h"
+#include "../BusGovernorMultiband.h"
+#include "BusGovernorStimuli.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#if defined (__x86_64__) || defined (_M_X64) || defined (__i386__) || defined (_M_IX86)
+ #if defined (_MSC_VER)
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+ static std::uint64_t readCycles()     { return __rdtsc(); }
+#else
+ static std::uint64_t readCycles()     { return 0; }
+#endif
+
+//==============================================================================
+namespace
+{
+    using BusGovernorStimuli::Stimulus;
+    using BusGovernorStimuli::getName;
+
+    //==============================================================================
+    struct Case
+    {
+        Stimulus stimulus;
+        int numChannels;
+        double sampleRate;
+        int blockSize;
+        float drive, pressure;
+        int bands = 0;          // 0 = wideband core, else the multiband path
+        std::string variant {}; // empty = the plugin's path, else a named alternative
+        int buses = 0;          // > 0: that many independent buses, each fed the stimulus
+        int rateFactor = 1;     // run at sampleRate * this, blocks as long in host time
+
+        double processRate() const      { return sampleRate * rateFactor; }
+        int processBlockSize() const    { return blockSize * rateFactor; }
+
+        std::string key() const
+        {
+            char buf[160];
+            int len = std::snprintf (buf, sizeof (buf), "%s/ch%d/sr%d/bs%d/drive%.2f/pressure%.2f",
+                                     getName (stimulus), numChannels, (int) sampleRate, blockSize, drive, pressure);
+
+            if (bands > 0)
+                len += std::snprintf (buf + len, sizeof (buf) - (size_t) len, "/bands%d", bands);
+
+            if (buses > 0)
+                len += std::snprintf (buf + len, sizeof (buf) - (size_t) len, "/buses%d", buses);
+
+            if (rateFactor > 1)
+                len += std::snprintf (buf + len, sizeof (buf) - (size_t) len, "/rate%dx", rateFactor);
+
+            if (! variant.empty())
+                std::snprintf (buf + len, sizeof (buf) - (size_t) len, "/%s", variant.c_str());
+
+            return buf;
+        }
+    };
+
+    struct Result
+    {
+        Case c;
+        double nsPerSample, cyclesPerSample, instancesPerCore;
+    };
+
+    // Every processor has a Sample type and takes (channels, numChannels,
+    // numSamples), the way processBlock hands the engine its buffer
+    template <typename PowEngine, typename SampleType = float>
+    struct CoreProcessorT
+    {
+        using Sample = SampleType;
+
+        BusGovernorCoreT<PowEngine, SampleType> core;
+        std::vector<SampleType> weights;
+        BusGovernorParameters settings, alternate;
+        bool ramp = false, flip = false;
+
+        void reset (const Case& c)
+        {
+            // "trim": volume off unity, so the non-unity kernel runs.
+            // "ramp": a new drive target every block, so the ramped path runs.
+            // "ecoN": control interval N.
+            settings  = { c.pressure, c.drive, c.variant == "trim" ? 0.5f : 1.0f };
+            alternate = { c.pressure, c.drive * 1.25f, settings.volume };
+            ramp = c.variant == "ramp";
+            flip = false;
+
+            core.reset();
+            core.setParameters (settings);
+
+            if (c.variant.compare (0, 3, "eco") == 0)
+                core.setControlInterval (std::atoi (c.variant.c_str() + 3));
+
+            // Wider layouts take the linked detector, every channel weighted once
+            weights.assign ((size_t) c.numChannels, SampleType (1));
+        }
+
+        void process (SampleType* const* channels, int numChannels, int n)
+        {
+            if (ramp)
+            {
+                flip = ! flip;
+                core.setTargetParameters (flip ? alternate : settings);
+            }
+
+            if (numChannels > 2)
+                core.process (channels, weights.data(), numChannels, n);
+            else
+                core.process (channels[0], numChannels > 1 ? channels[1] : nullptr, n);
+        }
+    };
+
+    using CoreProcessor = CoreProcessorT<BusGovernorPow>;
+
+    // "lookaheadNms": the windowed linked detector and delay ahead of the
+    // core, as processBlock runs them with lookahead on
+    struct LookaheadProcessor
+    {
+        using Sample = float;
+
+        BusGovernorCore core;
+        BusGovernorLookahead lookahead;
+        std::vector<float> weights, detector;
+
+        void reset (const Case& c)
+        {
+            const int samples = (int) std::lround (std::atof (c.variant.c_str() + 9) * 0.001 * c.processRate());
+
+            core.reset();
+            core.setParameters ({ c.pressure, c.drive, 1.0f });
+
+            lookahead.prepare (c.numChannels, samples);
+            lookahead.setLookahead (samples);
+
+            weights.assign ((size_t) c.numChannels, 1.0f);
+            detector.assign ((size_t) c.processBlockSize(), 0.0f);
+        }
+
+        void process (float* const* channels, int numChannels, int n)
+        {
+            lookahead.process (channels, weights.data(), numChannels, detector.data(), n);
+            core.process (channels, numChannels, detector.data(), n);
+        }
+    };
+
+    struct MultibandProcessor
+    {
+        using Sample = float;
+
+        BusGovernorMultiband multiband;
+
+        void reset (const Case& c)
+        {
+            multiband.prepare (c.processRate());
+            multiband.setNumBands (c.bands);
+
+            for (int j = 0; j < c.bands; ++j)
+                multiband.setBandParameters (j, { c.pressure, c.drive, 1.0f });
+        }
+
+        void process (float* const* channels, int numChannels, int n)
+        {
+            multiband.process (channels[0], numChannels > 1 ? channels[1] : nullptr, n);
+        }
+    };
+
+    // The multiband minus its crossovers: every band governs a copy of the
+    // input and the bands are summed, so bandsN less bandsN/lanes is what
+    // the crossover tree costs
+    struct LanesProcessor
+    {
+        using Sample = float;
+
+        BusGovernorBank bank;
+        std::vector<float> buffers;
+        int numBands = 1, blockSize = 0;
+
+        void reset (const Case& c)
+        {
+            numBands  = c.bands;
+            blockSize = c.processBlockSize();
+
+            bank.prepare (numBands);
+
+            for (int j = 0; j < numBands; ++j)
+                bank.setLaneParameters (j, { c.pressure, c.drive, 1.0f });
+
+            buffers.assign ((size_t) (numBands * 2 * blockSize), 0.0f);
+        }
+
+        void process (float* const* channels, int numChannels, int n)
+        {
+            float* l = channels[0];
+            float* r = numChannels > 1 ? channels[1] : nullptr;
+
+            float* left[BusGovernorMultiband::maxBands];
+            float* right[BusGovernorMultiband::maxBands];
+
+            for (int j = 0; j < numBands; ++j)
+            {
+                left[j]  = buffers.data() + (size_t) (2 * j * blockSize);
+                right[j] = r != nullptr ? left[j] + blockSize : nullptr;
+
+                std::copy (l, l + n, left[j]);
+
+                if (r != nullptr)
+                    std::copy (r, r + n, right[j]);
+            }
+
+            bank.process (left, right, n);
+
+            for (int ch = 0; ch < (r != nullptr ? 2 : 1); ++ch)
+            {
+                float* out = ch == 0 ? l : r;
+                float* const* in = ch == 0 ? left : right;
+
+                std::copy (in[0], in[0] + n, out);
+
+                for (int j = 1; j < numBands; ++j)
+                    for (int s = 0; s < n; ++s)
+                        out[s] += in[j][s];
+            }
+        }
+    };
+
+    // Independent buses, each its own copy of the stimulus: "bank" runs them
+    // as lanes of one BusGovernorBank, "scalar" as one BusGovernorCore each
+    // (the same fast pow as the bank). Bus 0 is copied back as the output.
+    template <bool useBank>
+    struct BusesProcessor
+    {
+        using Sample = float;
+
+        BusGovernorBank bank;
+        std::vector<BusGovernorCoreT<BusGovernorFastPow>> cores;
+        std::vector<float> buffers;
+        std::vector<float*> left, right;
+        int numBuses = 1, blockSize = 0;
+
+        void reset (const Case& c)
+        {
+            numBuses  = c.buses;
+            blockSize = c.processBlockSize();
+
+            if (useBank)
+            {
+                bank.prepare (numBuses);
+
+                for (int j = 0; j < numBuses; ++j)
+                    bank.setLaneParameters (j, { c.pressure, c.drive, 1.0f });
+            }
+            else
+            {
+                cores = std::vector<BusGovernorCoreT<BusGovernorFastPow>> ((size_t) numBuses);
+
+                for (auto& core : cores)
+                    core.setParameters ({ c.pressure, c.drive, 1.0f });
+            }
+
+            buffers.assign ((size_t) (numBuses * 2 * blockSize), 0.0f);
+            left.assign ((size_t) numBuses, nullptr);
+            right.assign ((size_t) numBuses, nullptr);
+        }
+
+        void process (float* const* channels, int numChannels, int n)
+        {
+            float* l = channels[0];
+            float* r = numChannels > 1 ? channels[1] : nullptr;
+
+            for (int j = 0; j < numBuses; ++j)
+            {
+                left[(size_t) j]  = buffers.data() + (size_t) (2 * j * blockSize);
+                right[(size_t) j] = r != nullptr ? left[(size_t) j] + blockSize : nullptr;
+
+                std::copy (l, l + n, left[(size_t) j]);
+
+                if (r != nullptr)
+                    std::copy (r, r + n, right[(size_t) j]);
+            }
+
+            if (useBank)
+                bank.process (left.data(), right.data(), n);
+            else
+                for (int j = 0; j < numBuses; ++j)
+                    cores[(size_t) j].process (left[(size_t) j], right[(size_t) j], n);
+
+            std::copy (left[0], left[0] + n, l);
+
+            if (r != nullptr)
+                std::copy (right[0], right[0] + n, r);
+        }
+    };
+
+    // Feeds all of work through in place, in blocks of blockSize
+    template <typename Processor, typename Sample>
+    void feed (Processor& processor, int blockSize, std::vector<std::vector<Sample>>& work)
+    {
+        const int numChannels = (int) work.size();
+        const int numSamples  = (int) work[0].size();
+        std::vector<Sample*> channels ((size_t) numChannels);
+
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                channels[(size_t) ch] = work[(size_t) ch].data() + start;
+
+            processor.process (channels.data(), numChannels, std::min (blockSize, numSamples - start));
+        }
+    }
+
+    template <typename Sample>
+    std::vector<std::vector<Sample>> makeStimulus (Stimulus type, int numChannels, double sampleRate, int numSamples)
+    {
+        const auto source = BusGovernorStimuli::make (type, numChannels, sampleRate, numSamples);
+        std::vector<std::vector<Sample>> out;
+
+        for (const auto& channel : source)
+            out.emplace_back (channel.begin(), channel.end());
+
+        return out;
+    }
+
+    // Untimed audio before the first timed run: long enough for the core to
+    // settle on silence (about 1.5 s from reset) and reach its sleep path
+    constexpr double settleSeconds = 2.0;
+
+    template <typename Processor>
+    Result runCase (const Case& c, double seconds, int runs)
+    {
+        using Sample = typename Processor::Sample;
+
+        const int blockSize  = c.processBlockSize();
+        const int numSamples = (int) (seconds * c.processRate());
+        const auto source = makeStimulus<Sample> (c.stimulus, c.numChannels, c.processRate(), numSamples);
+
+        // "wake": every run starts with the core asleep on settled silence
+        // and times the stimulus coming back
+        const bool wake = c.variant == "wake";
+        const auto silence = makeStimulus<Sample> (Stimulus::silence, c.numChannels, c.processRate(),
+                                                   (int) (settleSeconds * c.processRate()));
+
+        Processor processor;
+        std::vector<double> ns, cycles;
+
+        // Reset once; the settle pass also warms the caches. The runs carry
+        // the state on, so none starts from reset.
+        processor.reset (c);
+
+        for (double done = 0.0; ! wake && done < settleSeconds; done += seconds)
+        {
+            auto work = source;
+            feed (processor, blockSize, work);
+        }
+
+        for (int run = 0; run < runs; ++run)
+        {
+            if (wake)
+            {
+                auto work = silence;
+                feed (processor, blockSize, work);
+            }
+
+            auto work = source;
+
+            const auto t0 = std::chrono::steady_clock::now();
+            const auto c0 = readCycles();
+
+            feed (processor, blockSize, work);
+
+            const auto c1 = readCycles();
+            const auto t1 = std::chrono::steady_clock::now();
+
+            // Per host sample frame (so the /rateNx cases count each frame
+            // once), and per bus for the bus cases, so inst/core counts buses
+            const double frames = (double) numSamples / c.rateFactor * std::max (1, c.buses);
+
+            ns.push_back (std::chrono::duration<double, std::nano> (t1 - t0).count() / frames);
+            cycles.push_back ((double) (c1 - c0) / frames);
+        }
+
+        std::sort (ns.begin(), ns.end());
+        std::sort (cycles.begin(), cycles.end());
+
+        const double nsMedian = ns[ns.size() / 2];
+
+        return { c, nsMedian, cycles[cycles.size() / 2], 1.0e9 / (nsMedian * c.sampleRate) };
+    }
+
+    Result run (const Case& c, double seconds, int runs)
+    {
+        if (c.buses > 0)
+            return c.variant == "bank" ? runCase<BusesProcessor<true>> (c, seconds, runs)
+                                       : runCase<BusesProcessor<false>> (c, seconds, runs);
+
+        if (c.bands > 0)
+            return c.variant == "lanes" ? runCase<LanesProcessor> (c, seconds, runs)
+                                        : runCase<MultibandProcessor> (c, seconds, runs);
+
+        if (c.variant == "stdpow")     return runCase<CoreProcessorT<BusGovernorStdPow>> (c, seconds, runs);
+        if (c.variant == "fastpow")    return runCase<CoreProcessorT<BusGovernorFastPow>> (c, seconds, runs);
+        if (c.variant == "double")     return runCase<CoreProcessorT<BusGovernorPow, double>> (c, seconds, runs);
+
+        if (c.variant.compare (0, 9, "lookahead") == 0)
+            return runCase<LookaheadProcessor> (c, seconds, runs);
+
+        return runCase<CoreProcessor> (c, seconds, runs);
+    }
+
+    //==============================================================================
+    // --error-sweep: the fast pow against double-precision pow on a grid,
+    // plus the cost per call of both engines over the same grid
+    struct SweepRange
+    {
+        const char* name;
+        double baseMin, baseMax, expoMin, expoMax;
+    };
+
+    template <typename PowEngine>
+    double nsPerPow (const std::vector<float>& bases, const std::vector<float>& expos)
+    {
+        double best = 1.0e30;
+        volatile float sink = 0.0f;
+
+        for (int run = 0; run < 5; ++run)
+        {
+            float acc = 0.0f;
+            const auto t0 = std::chrono::steady_clock::now();
+
+            for (auto e : expos)
+                for (auto b : bases)
+                    acc += PowEngine::pow (b, e);
+
+            const auto t1 = std::chrono::steady_clock::now();
+            sink = acc;
+            best = std::min (best, std::chrono::duration<double, std::nano> (t1 - t0).count() / (double) (bases.size() * expos.size()));
+        }
+
+        (void) sink;
+        return best;
+    }
+
+    int runErrorSweep()
+    {
+        // The first range is the one BusGovernorMath.h documents; the second
+        // is what the recurrence reaches in practice
+        const SweepRange ranges[] = { { "documented", 1.0, 64.0, 0.5, 2.0 },
+                                      { "recurrence", 1.0, 25.0, 0.98, 1.5 } };
+        const int numBases = 4001, numExpos = 401;
+
+        std::printf ("%-12s %-22s %12s %12s %22s %10s %10s\n",
+                     "range", "base x expo", "max rel", "rms rel", "worst at (base, expo)", "std ns", "fast ns");
+
+        for (const auto& range : ranges)
+        {
+            std::vector<float> bases ((size_t) numBases), expos ((size_t) numExpos);
+
+            for (int i = 0; i < numBases; ++i)
+                bases[(size_t) i] = (float) (range.baseMin + (range.baseMax - range.baseMin) * i / (numBases - 1));
+
+            for (int i = 0; i < numExpos; ++i)
+                expos[(size_t) i] = (float) (range.expoMin + (range.expoMax - range.expoMin) * i / (numExpos - 1));
+
+            double maxError = 0.0, sumSquares = 0.0, worstBase = 0.0, worstExpo = 0.0;
+
+            for (auto e : expos)
+            {
+                for (auto b : bases)
+                {
+                    const double exact = std::pow ((double) b, (double) e);
+                    const double error = std::abs ((double) BusGovernorFastPow::pow (b, e) - exact) / exact;
+
+                    sumSquares += error * error;
+
+                    if (error > maxError)
+                    {
+                        maxError = error;
+                        worstBase = b;
+                        worstExpo = e;
+                    }
+                }
+            }
+
+            char grid[80], worst[64];
+            std::snprintf (grid, sizeof (grid), "[%g, %g] x [%g, %g]", range.baseMin, range.baseMax, range.expoMin, range.expoMax);
+            std::snprintf (worst, sizeof (worst), "(%.4f, %.4f)", worstBase, worstExpo);
+
+            std::printf ("%-12s %-22s %12.2e %12.2e %22s %10.2f %10.2f\n",
+                         range.name, grid, maxError, std::sqrt (sumSquares / ((double) numBases * numExpos)), worst,
+                         nsPerPow<BusGovernorStdPow> (bases, expos), nsPerPow<BusGovernorFastPow> (bases, expos));
+        }
+
+        return 0;
+    }
+
+    //==============================================================================
+    void writeJson (const std::string& path, const std::vector<Result>& results)
+    {
+        std::ofstream f (path);
+
+        f << "{\n  \"benchmark\": \"BusGovernorCore\",\n"
+          << "  \"fastMath\": " << BUSGOVERNOR_FAST_MATH << ",\n"
+          << "  \"results\": [\n";
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const auto& r = results[i];
+            char line[512];
+
+            std::snprintf (line, sizeof (line),
+                           "    { \"case\": \"%s\", \"stimulus\": \"%s\", \"channels\": %d, \"sampleRate\": %d, "
+                           "\"blockSize\": %d, \"drive\": %.2f, \"pressure\": %.2f, \"bands\": %d, \"buses\": %d, \"rateFactor\": %d, \"variant\": \"%s\", "
+                           "\"nsPerSample\": %.3f, \"cyclesPerSample\": %.1f, \"instancesPerCore\": %.1f }%s\n",
+                           r.c.key().c_str(), getName (r.c.stimulus), r.c.numChannels, (int) r.c.sampleRate,
+                           r.c.blockSize, r.c.drive, r.c.pressure, r.c.bands, r.c.buses, r.c.rateFactor, r.c.variant.c_str(),
+                           r.nsPerSample, r.cyclesPerSample, r.instancesPerCore,
+                           i + 1 < results.size() ? "," : "");
+            f << line;
+        }
+
+        f << "  ]\n}\n";
+    }
+
+    // Reads back what writeJson wrote (one result per line): case -> nsPerSample
+    std::map<std::string, double> readBaseline (const std::string& path)
+    {
+        std::map<std::string, double> out;
+        std::ifstream f (path);
+        std::string line;
+
+        while (std::getline (f, line))
+        {
+            const auto k = line.find ("\"case\": \"");
+            const auto v = line.find ("\"nsPerSample\": ");
+
+            if (k == std::string::npos || v == std::string::npos)
+                continue;
+
+            const auto keyStart = k + 9;
+            const auto keyEnd   = line.find ('"', keyStart);
+
+            out[line.substr (keyStart, keyEnd - keyStart)] = std::atof (line.c_str() + v + 15);
+        }
+
+        return out;
+    }
+}
+
+//==============================================================================
+int main (int argc, char** argv)
+{
+    bool quick = false, errorSweep = false;
+    std::string jsonPath, baselinePath;
+    double tolerance = 0.10, seconds = 1.0;
+    int runs = 5;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--quick")                        quick = true;
+        else if (arg == "--error-sweep")             errorSweep = true;
+        else if (arg == "--json" && hasValue)        jsonPath = argv[++i];
+        else if (arg == "--baseline" && hasValue)    baselinePath = argv[++i];
+        else if (arg == "--tolerance" && hasValue)   tolerance = std::atof (argv[++i]);
+        else if (arg == "--seconds" && hasValue)     seconds = std::atof (argv[++i]);
+        else if (arg == "--runs" && hasValue)        runs = std::max (1, std::atoi (argv[++i]));
+        else
+        {
+            std::fprintf (stderr, "usage: %s [--quick] [--error-sweep] [--json file] [--baseline file] [--tolerance x] [--seconds s] [--runs n]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (errorSweep)
+        return runErrorSweep();
+
+    const std::vector<int> blockSizes = quick ? std::vector<int> { 64, 512 }
+                                              : std::vector<int> { 16, 64, 256, 1024, 4096 };
+    const std::vector<double> sampleRates = quick ? std::vector<double> { 48000.0 }
+                                                  : std::vector<double> { 44100.0, 48000.0, 96000.0 };
+    const std::vector<std::pair<float, float>> settings = quick
+        ? std::vector<std::pair<float, float>> { { 5.8f, 0.27f } }
+        : std::vector<std::pair<float, float>> { { 5.8f, 0.27f }, { 1.0f, 0.0f }, { 24.0f, 1.0f } };   // drive, pressure
+
+    std::vector<Case> cases;
+
+    for (auto stimulus : { Stimulus::silence, Stimulus::sine, Stimulus::pink, Stimulus::drums })
+        for (int numChannels : { 1, 2 })
+            for (auto sr : sampleRates)
+                for (int bs : blockSizes)
+                    for (auto& s : settings)
+                        cases.push_back ({ stimulus, numChannels, sr, bs, s.first, s.second });
+
+    // The core with each pow engine, whichever one the build defaults to
+    for (auto stimulus : { Stimulus::pink, Stimulus::drums })
+        for (int numChannels : { 1, 2 })
+            for (int bs : quick ? std::vector<int> { 512 } : blockSizes)
+                for (const char* variant : { "stdpow", "fastpow" })
+                    cases.push_back ({ stimulus, numChannels, 48000.0, bs, 5.8f, 0.27f, 0, variant });
+
+    // The specialized kernels off their common path: volume off unity
+    // ("trim") and parameters ramping every block ("ramp"); then eco mode by
+    // control interval
+    for (auto stimulus : { Stimulus::pink, Stimulus::drums })
+        for (int numChannels : { 1, 2 })
+            for (int bs : quick ? std::vector<int> { 512 } : blockSizes)
+                for (const char* variant : { "trim", "ramp", "eco4", "eco8", "eco16", "eco32" })
+                    cases.push_back ({ stimulus, numChannels, 48000.0, bs, 5.8f, 0.27f, 0, variant });
+
+    // The core alone at 2-8x the host rate, per host frame. The plugin's
+    // half-band filters are JUCE's and not part of this tool, so these time
+    // the governor's share of an oversampled block only.
+    for (int numChannels : { 1, 2 })
+        for (int bs : quick ? std::vector<int> { 512 } : blockSizes)
+            for (int factor : { 2, 4, 8 })
+                cases.push_back ({ Stimulus::pink, numChannels, 48000.0, bs, 5.8f, 0.27f, 0, "", 0, factor });
+
+    // Surround and immersive layouts on the linked detector
+    for (int numChannels : quick ? std::vector<int> { 6, 8 } : std::vector<int> { 3, 6, 8, 12, 16, 24 })
+        for (int bs : quick ? std::vector<int> { 512 } : blockSizes)
+            cases.push_back ({ Stimulus::pink, numChannels, 48000.0, bs, 5.8f, 0.27f });
+
+    // The double-precision core, as 64-bit hosts run it
+    for (auto stimulus : { Stimulus::pink, Stimulus::drums })
+        for (int numChannels : { 1, 2 })
+            for (int bs : quick ? std::vector<int> { 512 } : blockSizes)
+                cases.push_back ({ stimulus, numChannels, 48000.0, bs, 5.8f, 0.27f, 0, "double" });
+
+    // Lookahead: the sliding-window detector and delay ahead of the core
+    for (int numChannels : { 2, 6 })
+        for (int bs : quick ? std::vector<int> { 512 } : blockSizes)
+            for (const char* variant : { "lookahead1ms", "lookahead5ms" })
+                cases.push_back ({ Stimulus::pink, numChannels, 48000.0, bs, 5.8f, 0.27f, 0, variant });
+
+    // Signal returning to a core asleep on silence (see runCase)
+    for (auto stimulus : quick ? std::vector<Stimulus> { Stimulus::pink }
+                               : std::vector<Stimulus> { Stimulus::sine, Stimulus::pink, Stimulus::drums })
+        for (int numChannels : { 1, 2 })
+            for (int bs : blockSizes)
+                cases.push_back ({ stimulus, numChannels, 48000.0, bs, 5.8f, 0.27f, 0, "wake" });
+
+    // Multiband by band count, default drive/pressure on every band
+    const auto bandStimuli = quick ? std::vector<Stimulus> { Stimulus::pink }
+                                   : std::vector<Stimulus> { Stimulus::pink, Stimulus::drums };
+
+    for (auto stimulus : bandStimuli)
+        for (int numChannels : { 1, 2 })
+            for (auto sr : sampleRates)
+                for (int bs : blockSizes)
+                    for (int bands = 1; bands <= BusGovernorMultiband::maxBands; ++bands)
+                        for (const char* variant : { "", "lanes" })
+                            cases.push_back ({ stimulus, numChannels, sr, bs, 5.8f, 0.27f, bands, variant });
+
+    // Per-bus cost of N buses in one bank against N scalar cores
+    for (int numChannels : { 1, 2 })
+        for (int bs : quick ? std::vector<int> { 512 } : blockSizes)
+            for (int buses : quick ? std::vector<int> { 4, 16 } : std::vector<int> { 1, 2, 4, 8, 16, 32 })
+                for (const char* variant : { "bank", "scalar" })
+                    cases.push_back ({ Stimulus::pink, numChannels, 48000.0, bs, 5.8f, 0.27f, 0, variant, buses });
+
+    const auto baseline = baselinePath.empty() ? std::map<std::string, double>() : readBaseline (baselinePath);
+
+    std::vector<Result> results;
+    int regressions = 0;
+
+    std::printf ("%-60s %10s %10s %10s %9s\n", "case", "ns/sample", "cyc/sample", "inst/core", "vs base");
+
+    for (const auto& c : cases)
+    {
+        const auto r = run (c, seconds, runs);
+        results.push_back (r);
+
+        char delta[32] = "";
+        const auto it = baseline.find (c.key());
+
+        if (it != baseline.end() && it->second > 0.0)
+        {
+            const double change = r.nsPerSample / it->second - 1.0;
+            const bool regressed = change > tolerance;
+            regressions += regressed ? 1 : 0;
+            std::snprintf (delta, sizeof (delta), "%+.1f%%%s", change * 100.0, regressed ? " !" : "");
+        }
+
+        std::printf ("%-60s %10.2f %10.1f %10.1f %9s\n",
+                     c.key().c_str(), r.nsPerSample, r.cyclesPerSample, r.instancesPerCore, delta);
+    }
+
+    if (! jsonPath.empty())
+        writeJson (jsonPath, results);
+
+    if (! baseline.empty())
+        std::printf ("\n%d of %d cases slower than baseline by more than %.0f%%\n",
+                     regressions, (int) cases.size(), tolerance * 100.0);
+
+    return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,328 @@
+/*
+  ==============================================================================
+
+    BusGovernorCoreTests - unit tests of BusGovernorCore's contract, the
+    parts BusGovernorVerify's whole-signal comparison does not pin down:
+
+        helpers       advance(), shape() and atLeast() against the formulas
+                      worked by hand in double
+        empty block   numSamples <= 0 leaves buffers, state and stats alone
+        reset         reset() gives the output of a fresh core, bit for bit
+        state         getState()/setState() resumes bit for bit (also eco)
+        mono/stereo   mono equals stereo with both channels the same
+        ramp          setTargetParameters() matches a per-sample loop over
+                      advance()/shape(), ends on the target parameters and
+                      is not repeated in the next block
+        sleep         the silence fast path is bit-identical to the full
+                      path, and actually engages
+
+    No JUCE needed; from the repository root:
+
+        c++ -O3 -std=c++17 -o BusGovernorCoreTests Tools/BusGovernorCoreTests.cpp
+
+    Prints one line per failed check and exits with 1 if any failed.
+
+  ==============================================================================
+*/
+
+#include "../BusGovernorCore.h"
+#include "BusGovernorStimuli.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+//==============================================================================
+namespace
+{
+    using BusGovernorStimuli::Stimulus;
+    using State = BusGovernorCore::State;
+
+    constexpr double sampleRate = 48000.0;
+    constexpr int    blockSize  = 512;
+
+    int failures = 0;
+
+    void check (bool ok, const char* test, const char* what)
+    {
+        if (! ok)
+        {
+            std::printf ("FAIL  %-12s %s\n", test, what);
+            ++failures;
+        }
+    }
+
+    bool near (double x, double expected, double tolerance)
+    {
+        return std::abs (x - expected) <= tolerance * std::max (1.0, std::abs (expected));
+    }
+
+    bool sameBits (const std::vector<float>& x, const std::vector<float>& y)
+    {
+        return x.size() == y.size() && std::memcmp (x.data(), y.data(), x.size() * sizeof (float)) == 0;
+    }
+
+    bool sameState (const State& x, const State& y)
+    {
+        return std::memcmp (&x, &y, sizeof (State)) == 0;
+    }
+
+    // Runs the core over x in blocks of blockSize, in place
+    void run (BusGovernorCore& core, std::vector<float>& l, std::vector<float>* r)
+    {
+        const int total = (int) l.size();
+
+        for (int start = 0; start < total; start += blockSize)
+            core.process (l.data() + start, r != nullptr ? r->data() + start : nullptr,
+                          std::min (blockSize, total - start));
+    }
+
+    std::vector<float> signal (Stimulus type, double seconds)
+    {
+        return BusGovernorStimuli::make (type, 1, sampleRate, (int) (seconds * sampleRate))[0];
+    }
+
+    //==============================================================================
+    void testHelpers()
+    {
+        const char* name = "helpers";
+
+        check (BusGovernorCore::atLeast (2.0f, BusGovernorCore::eps) == 2.0f, name, "atLeast keeps x above the floor");
+        check (near (BusGovernorCore::atLeast (0.0f, BusGovernorCore::eps), 1.0e-12, 1.0e-6), name, "atLeast clamps to the floor");
+
+        // One step from the initial state a = b = 1
+        const double det = 0.3, drive = 5.8;
+        const double a = 0.988 * 1.0 + 0.012 * det * det * drive;
+        const double b = 0.992 * (a + std::abs (1.0 - a)) + 0.008 * std::pow (1.0 + std::abs (a - 1.0), a);
+
+        State st;
+        const float invb = BusGovernorCore::advance (st, (float) det, (float) drive);
+
+        check (near (st.a, a, 1.0e-6),      name, "advance: a");
+        check (near (st.b, b, 1.0e-5),      name, "advance: b");
+        check (near (invb, 1.0 / b, 1.0e-5), name, "advance returns 1/b");
+
+        // out = in/b, d = out/b - out, out + pressure * d / (1 + 6|d|)
+        const double in = 0.5, gain = 0.5, pressure = 0.27;
+        const double out = in * gain, d = out * gain - out;
+        const double shaped = out + pressure * d / (1.0 + 6.0 * std::abs (d));
+
+        check (near (BusGovernorCore::shape ((float) in, (float) gain, (float) pressure), shaped, 1.0e-6), name, "shape");
+        check (BusGovernorCore::shape (0.5f, 1.0f, 1.0f) == 0.5f, name, "shape is the identity at b = 1");
+    }
+
+    void testEmptyBlock()
+    {
+        const char* name = "empty block";
+
+        BusGovernorCore core;
+        auto x = signal (Stimulus::pink, 0.1);
+        run (core, x, nullptr);
+
+        const State before = core.getState();
+        const BusGovernorBlockStats stats = core.getBlockStats();
+
+        std::vector<float> l (64, 0.5f), r (64, -0.5f);
+        const std::vector<float> l0 = l, r0 = r;
+
+        core.process (l.data(), r.data(), 0);
+        core.process (l.data(), r.data(), -1);
+        core.process (l.data(), nullptr, 0);
+
+        float* channels[] = { l.data(), r.data() };
+        const float weights[] = { 1.0f, 1.0f };
+        core.process (channels, weights, 2, 0);
+        core.process (channels, 2, l.data(), -64);
+
+        check (sameBits (l, l0) && sameBits (r, r0), name, "buffers untouched");
+        check (sameState (core.getState(), before), name, "state untouched");
+        check (std::memcmp (&stats, &core.getBlockStats(), sizeof (stats)) == 0, name, "block stats untouched");
+    }
+
+    void testReset()
+    {
+        const char* name = "reset";
+
+        const auto x = signal (Stimulus::drums, 1.0);
+
+        BusGovernorCore fresh, used;
+        auto warmup = signal (Stimulus::hot, 0.5);
+        run (used, warmup, nullptr);
+
+        used.reset();
+        check (sameState (used.getState(), State()), name, "state back to the initial one");
+
+        auto expected = x, actual = x;
+        run (fresh, expected, nullptr);
+        run (used, actual, nullptr);
+
+        check (sameBits (actual, expected), name, "output equals a fresh core");
+    }
+
+    void testState()
+    {
+        const char* name = "state";
+
+        for (int interval : { 1, 8 })
+        {
+            const auto x = signal (Stimulus::pink, 1.0);
+            std::vector<float> head (x.begin(), x.begin() + x.size() / 2 + 37);   // off the eco grid
+            std::vector<float> tail (x.begin() + (long) head.size(), x.end());
+
+            BusGovernorCore core;
+            core.setControlInterval (interval);
+            run (core, head, nullptr);
+
+            const State saved = core.getState();
+            auto first = tail;
+            run (core, first, nullptr);
+
+            // A different core, so nothing but the state carries over
+            BusGovernorCore restored;
+            restored.setControlInterval (interval);
+            restored.setState (saved);
+            auto second = tail;
+            run (restored, second, nullptr);
+
+            check (sameBits (first, second), name, interval == 1 ? "resumes bit for bit" : "resumes bit for bit (eco)");
+        }
+    }
+
+    void testMonoStereo()
+    {
+        const char* name = "mono/stereo";
+
+        const auto x = signal (Stimulus::drums, 1.0);
+
+        BusGovernorCore mono, stereo;
+        auto m = x, l = x, r = x;
+        run (mono, m, nullptr);
+        run (stereo, l, &r);
+
+        check (sameBits (m, l) && sameBits (m, r), name, "mono equals stereo with l = r");
+        check (sameState (mono.getState(), stereo.getState()), name, "same state after");
+    }
+
+    void testRamp()
+    {
+        const char* name = "ramp";
+
+        const BusGovernorParameters from { 0.27f, 5.8f, 1.0f }, to { 1.0f, 24.0f, 0.5f };
+        const int n = 300;   // not a multiple of the chunk size
+
+        auto x = signal (Stimulus::pink, 1.0);
+        std::vector<float> l (x.begin(), x.begin() + n), r (x.begin() + n, x.begin() + 2 * n);
+
+        BusGovernorCore core;
+        core.setParameters (from);
+        core.setTargetParameters (to);
+
+        // Per-sample reference: sample k of the block is k + 1 steps along
+        std::vector<float> expectedL = l, expectedR = r;
+        State st;
+        const float inc = 1.0f / (float) n;
+        float lastPressure = 0, lastDrive = 0, lastVolume = 0;
+
+        for (int s = 0; s < n; ++s)
+        {
+            const float k = (float) (s + 1);
+            lastPressure = from.pressure + (to.pressure - from.pressure) * inc * k;
+            lastDrive    = from.drive    + (to.drive    - from.drive)    * inc * k;
+            lastVolume   = from.volume   + (to.volume   - from.volume)   * inc * k;
+
+            const float invb = BusGovernorCore::advance (st, std::abs (l[(size_t) s] + r[(size_t) s]), lastDrive);
+            expectedL[(size_t) s] = BusGovernorCore::shape (l[(size_t) s], invb, lastPressure) * lastVolume;
+            expectedR[(size_t) s] = BusGovernorCore::shape (r[(size_t) s], invb, lastPressure) * lastVolume;
+        }
+
+        core.process (l.data(), r.data(), n);
+
+        double err = 0.0;
+
+        for (int s = 0; s < n; ++s)
+            err = std::max (err, (double) std::max (std::abs (l[(size_t) s] - expectedL[(size_t) s]),
+                                                    std::abs (r[(size_t) s] - expectedR[(size_t) s])));
+
+        check (err <= 1.0e-6, name, "matches the per-sample ramp");
+        check (near (st.b, core.getState().b, 1.0e-6), name, "same b at the end");
+
+        check (near (lastPressure, to.pressure, 1.0e-6) && near (lastDrive, to.drive, 1.0e-6)
+                   && near (lastVolume, to.volume, 1.0e-6), name, "last sample on the target");
+
+        const auto& p = core.getParameters();
+        check (p.pressure == to.pressure && p.drive == to.drive && p.volume == to.volume, name, "parameters set to the target");
+
+        // The next block runs constant at the target
+        BusGovernorCore constant;
+        constant.setParameters (to);
+        constant.setState (core.getState());
+
+        std::vector<float> a (x.begin() + 2 * n, x.begin() + 3 * n), b = a;
+        core.process (a.data(), nullptr, n);
+        constant.process (b.data(), nullptr, n);
+
+        check (sameBits (a, b), name, "next block constant at the target");
+    }
+
+    void testSleep()
+    {
+        const char* name = "sleep";
+
+        for (int interval : { 1, 8 })
+        {
+            // Signal, then long enough near-silence for the state to settle:
+            // noise around -130 dBFS, under the threshold but not zero, so a
+            // wrong sleep gain would show in the output
+            auto x = signal (Stimulus::drums, 0.5);
+            auto quiet = signal (Stimulus::pink, 20.0);
+
+            for (auto& v : quiet)
+                x.push_back (v * 1.0e-6f);
+
+            BusGovernorCore awake, asleep;
+            awake.setSleepEnabled (false);
+            asleep.setSleepEnabled (true);
+            awake.setControlInterval (interval);
+            asleep.setControlInterval (interval);
+
+            auto expected = x, actual = x;
+            float slept = 0.0f;
+
+            for (size_t start = 0; start < x.size(); start += blockSize)
+            {
+                const int n = (int) std::min ((size_t) blockSize, x.size() - start);
+                awake.process (expected.data() + start, nullptr, n);
+                asleep.process (actual.data() + start, nullptr, n);
+                slept += asleep.getBlockStats().sleepFraction * (float) n;
+            }
+
+            // Signal again after the silence: the wake up must be exact too
+            auto wakeExpected = signal (Stimulus::drums, 0.5), wakeActual = wakeExpected;
+            run (awake, wakeExpected, nullptr);
+            run (asleep, wakeActual, nullptr);
+
+            check (slept > 0.5f * (float) sampleRate, name, interval == 1 ? "engages on silence" : "engages on silence (eco)");
+            check (sameBits (expected, actual) && sameBits (wakeExpected, wakeActual), name,
+                   interval == 1 ? "bit-identical" : "bit-identical (eco)");
+            check (sameState (awake.getState(), asleep.getState()), name, "same state after");
+        }
+    }
+}
+
+//==============================================================================
+int main()
+{
+    testHelpers();
+    testEmptyBlock();
+    testReset();
+    testState();
+    testMonoStereo();
+    testRamp();
+    testSleep();
+
+    if (failures == 0)
+        std::printf ("all core tests passed\n");
+
+    return failures == 0 ? 0 : 1;
+}
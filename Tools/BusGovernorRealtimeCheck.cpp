@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+    BusGovernorRealtimeCheck - real-time safety test for processBlock.
+
+    Runs BusGovernorAudioProcessor with its editor open: prepareToPlay, then
+    thousands of processBlock calls of varying length on an audio thread,
+    with random parameter changes between blocks (every parameter, so
+    oversampling, lookahead, bands, auto match and anticipation all switch
+    back and forth). Meanwhile the message thread runs the editor's timer
+    and paints and resizes it. Any allocation, lock or blocking call inside
+    processBlock (or inside an anticipated block on a pool worker) aborts
+    with the call and a stack trace (see BusGovernorRealtimeInterpose.h).
+
+    Build as a JUCE console app linked against the plugin's shared code,
+    the whole of it compiled with BUSGOVERNOR_RT_GUARD=1 (a test build;
+    never ship it), Linux only:
+
+        -DBUSGOVERNOR_RT_GUARD=1 -rdynamic, link with -ldl
+
+    Options:
+
+        --blocks <n>     processBlock calls (default 20000)
+        --block <n>      prepared block size (default 256); calls vary up to it
+        --rate <hz>      sample rate (default 48000)
+        --double         double precision processing
+        --seed <n>       random seed (default 1)
+
+    Exits 0 when every block ran clean.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "../PluginProcessor.h"
+#include "BusGovernorRealtimeInterpose.h"
+
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <thread>
+
+#if ! (BUSGOVERNOR_RT_GUARD && defined (__linux__))
+ #error "BusGovernorRealtimeCheck needs Linux and BUSGOVERNOR_RT_GUARD=1"
+#endif
+
+//==============================================================================
+namespace
+{
+    struct Options
+    {
+        int numBlocks = 20000;
+        int blockSize = 256;
+        double sampleRate = 48000.0;
+        bool doublePrecision = false;
+        unsigned seed = 1;
+    };
+
+    // The host side of the audio thread: parameter automation between
+    // blocks, then one processBlock on noise of a random length
+    template <typename SampleType>
+    void runAudio (BusGovernorAudioProcessor& processor, const Options& options, std::atomic<int>& blocksDone)
+    {
+        std::mt19937 rng (options.seed);
+        std::uniform_real_distribution<float> unit (0.0f, 1.0f);
+        std::uniform_int_distribution<int> length (1, options.blockSize);
+
+        auto& params = processor.getParameters();
+        std::uniform_int_distribution<int> pick (0, params.size() - 1);
+
+        juce::AudioBuffer<SampleType> buffer (processor.getTotalNumOutputChannels(), options.blockSize);
+        juce::MidiBuffer midi;
+
+        for (int b = 0; b < options.numBlocks; ++b)
+        {
+            if (b % 16 == 0)
+                for (int k = 0; k < 3; ++k)
+                    params[pick (rng)]->setValueNotifyingHost (unit (rng));
+
+            const int n = length (rng);
+            buffer.setSize (buffer.getNumChannels(), n, false, false, true);
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                for (int i = 0; i < n; ++i)
+                    buffer.setSample (ch, i, (SampleType) (0.5f * (unit (rng) * 2.0f - 1.0f)));
+
+            processor.processBlock (buffer, midi);
+            blocksDone.store (b + 1, std::memory_order_relaxed);
+        }
+    }
+}
+
+//==============================================================================
+int main (int argc, char** argv)
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    Options options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String arg (argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--blocks" && hasValue)      options.numBlocks = juce::jmax (1, juce::String (argv[++i]).getIntValue());
+        else if (arg == "--block" && hasValue)  options.blockSize = juce::jmax (1, juce::String (argv[++i]).getIntValue());
+        else if (arg == "--rate" && hasValue)   options.sampleRate = juce::String (argv[++i]).getDoubleValue();
+        else if (arg == "--seed" && hasValue)   options.seed = (unsigned) juce::String (argv[++i]).getIntValue();
+        else if (arg == "--double")             options.doublePrecision = true;
+        else
+        {
+            std::fprintf (stderr, "usage: %s [--blocks n] [--block n] [--rate hz] [--double] [--seed n]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    BusGovernorAudioProcessor processor;
+
+    processor.setProcessingPrecision (options.doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                              : juce::AudioProcessor::singlePrecision);
+    processor.setRateAndBufferSizeDetails (options.sampleRate, options.blockSize);
+    processor.prepareToPlay (options.sampleRate, options.blockSize);
+
+    std::unique_ptr<juce::AudioProcessorEditor> editor (processor.createEditorAndMakeActive());
+
+    std::atomic<int> blocksDone { 0 };
+
+    std::thread audio ([&]
+    {
+        if (options.doublePrecision)
+            runAudio<double> (processor, options, blocksDone);
+        else
+            runAudio<float> (processor, options, blocksDone);
+    });
+
+    // Message thread: the editor's timer runs from the dispatch loop; paint
+    // into an image and resize now and then
+    for (int frame = 0; blocksDone.load (std::memory_order_relaxed) < options.numBlocks; ++frame)
+    {
+        juce::MessageManager::getInstance()->runDispatchLoopUntil (10);
+
+        if (editor != nullptr)
+        {
+            if (frame % 5 == 0)
+                (void) editor->createComponentSnapshot (editor->getLocalBounds());
+
+            if (frame % 50 == 0)
+                editor->setSize (400 + (frame / 50) % 2 * 40, 390 + (frame / 50) % 2 * 39);
+        }
+    }
+
+    audio.join();
+    editor.reset();
+    processor.releaseResources();
+
+    const auto cpu = processor.getHostCpuStats();
+    const auto ahead = processor.getAnticipationStats();
+
+    std::printf ("%d blocks clean (%llu anticipated, %llu inline fallbacks), worst block %.1f%% of budget\n",
+                 options.numBlocks, (unsigned long long) ahead.blocks, (unsigned long long) ahead.fallbacks,
+                 100.0 * cpu.maxLoad);
+
+    return 0;
+}
@@ -0,0 +1,240 @@
+/*
+  ==============================================================================
+
+    Linux interposers for the real-time checker (see BusGovernorRealtimeGuard).
+
+    Defines malloc/calloc/realloc/free and the aligned allocators (which
+    operator new and delete go through), mutex and rwlock locking,
+    condition and semaphore waits, thread joins, sleeps and blocking I/O
+    (read, write, poll, select) in the executable, so every caller in the
+    process resolves to these first. Each one checks the guard and then
+    forwards to glibc. Inside a guarded scope the first call prints what
+    was called and a stack trace, then aborts.
+
+    Include in exactly one translation unit of a test executable built with
+    BUSGOVERNOR_RT_GUARD=1 (the guard's thread-local must be in the
+    executable's static TLS, not a dlopen()ed library's). Link with -ldl
+    on older glibc; -rdynamic gives the trace function names.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../BusGovernorRealtimeGuard.h"
+
+#if BUSGOVERNOR_RT_GUARD && defined (__linux__)
+
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <poll.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/select.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+extern "C"
+{
+    void* __libc_malloc (size_t);
+    void* __libc_calloc (size_t, size_t);
+    void* __libc_realloc (void*, size_t);
+    void* __libc_memalign (size_t, size_t);
+    void  __libc_free (void*);
+}
+
+//==============================================================================
+namespace BusGovernorRealtimeInterpose
+{
+    [[noreturn]] inline void violation (const char* what) noexcept
+    {
+        BusGovernorRealtimeGuard::depth() = 0;   // the report itself may allocate
+
+        const char header[] = "\n*** real-time violation: ";
+        const char footer[] = " called inside the audio callback\n";
+
+        (void) ::write (2, header, sizeof (header) - 1);
+        (void) ::write (2, what, std::strlen (what));
+        (void) ::write (2, footer, sizeof (footer) - 1);
+
+        void* frames[64];
+        backtrace_symbols_fd (frames, backtrace (frames, 64), 2);
+
+        std::abort();
+    }
+
+    inline void check (const char* what) noexcept
+    {
+        if (BusGovernorRealtimeGuard::isActive())
+            violation (what);
+    }
+
+    template <typename Fn>
+    Fn next (const char* name) noexcept
+    {
+        return reinterpret_cast<Fn> (dlsym (RTLD_NEXT, name));
+    }
+
+    // The forwarding targets, looked up before main(); backtrace() is primed
+    // too, since its first call loads libgcc_s (and allocates)
+    struct Real
+    {
+        int (*mutexLock) (pthread_mutex_t*)                             = next<decltype (mutexLock)> ("pthread_mutex_lock");
+        int (*rwlockRead) (pthread_rwlock_t*)                           = next<decltype (rwlockRead)> ("pthread_rwlock_rdlock");
+        int (*rwlockWrite) (pthread_rwlock_t*)                          = next<decltype (rwlockWrite)> ("pthread_rwlock_wrlock");
+        int (*condWait) (pthread_cond_t*, pthread_mutex_t*)             = next<decltype (condWait)> ("pthread_cond_wait");
+        int (*condTimedWait) (pthread_cond_t*, pthread_mutex_t*, const timespec*) = next<decltype (condTimedWait)> ("pthread_cond_timedwait");
+        int (*join) (pthread_t, void**)                                 = next<decltype (join)> ("pthread_join");
+        int (*semWait) (sem_t*)                                         = next<decltype (semWait)> ("sem_wait");
+        int (*nanosleep) (const timespec*, timespec*)                   = next<decltype (nanosleep)> ("nanosleep");
+        int (*clockNanosleep) (clockid_t, int, const timespec*, timespec*) = next<decltype (clockNanosleep)> ("clock_nanosleep");
+        int (*usleep) (useconds_t)                                      = next<decltype (usleep)> ("usleep");
+        unsigned (*sleep) (unsigned)                                    = next<decltype (sleep)> ("sleep");
+        ssize_t (*read) (int, void*, size_t)                            = next<decltype (read)> ("read");
+        ssize_t (*write) (int, const void*, size_t)                     = next<decltype (write)> ("write");
+        int (*poll) (pollfd*, nfds_t, int)                              = next<decltype (poll)> ("poll");
+        int (*select) (int, fd_set*, fd_set*, fd_set*, timeval*)        = next<decltype (select)> ("select");
+
+        Real()
+        {
+            void* frames[4];
+            (void) backtrace (frames, 4);
+        }
+    };
+
+    inline Real& real() noexcept
+    {
+        static Real r;
+        return r;
+    }
+
+    static const Real& primed = real();
+}
+
+//==============================================================================
+extern "C"
+{
+    void* malloc (size_t n)                 { BusGovernorRealtimeInterpose::check ("malloc");  return __libc_malloc (n); }
+    void* calloc (size_t c, size_t n)       { BusGovernorRealtimeInterpose::check ("calloc");  return __libc_calloc (c, n); }
+    void* realloc (void* p, size_t n)       { BusGovernorRealtimeInterpose::check ("realloc"); return __libc_realloc (p, n); }
+
+    void free (void* p)
+    {
+        if (p != nullptr)
+            BusGovernorRealtimeInterpose::check ("free");
+
+        __libc_free (p);
+    }
+
+    void* memalign (size_t a, size_t n)     { BusGovernorRealtimeInterpose::check ("memalign");      return __libc_memalign (a, n); }
+    void* aligned_alloc (size_t a, size_t n) { BusGovernorRealtimeInterpose::check ("aligned_alloc"); return __libc_memalign (a, n); }
+
+    int posix_memalign (void** out, size_t a, size_t n)
+    {
+        BusGovernorRealtimeInterpose::check ("posix_memalign");
+
+        if (a < sizeof (void*) || (a & (a - 1)) != 0)
+            return EINVAL;
+
+        *out = __libc_memalign (a, n);
+        return *out != nullptr ? 0 : ENOMEM;
+    }
+
+    //==============================================================================
+    int pthread_mutex_lock (pthread_mutex_t* m)
+    {
+        BusGovernorRealtimeInterpose::check ("pthread_mutex_lock");
+        return BusGovernorRealtimeInterpose::real().mutexLock (m);
+    }
+
+    int pthread_rwlock_rdlock (pthread_rwlock_t* l)
+    {
+        BusGovernorRealtimeInterpose::check ("pthread_rwlock_rdlock");
+        return BusGovernorRealtimeInterpose::real().rwlockRead (l);
+    }
+
+    int pthread_rwlock_wrlock (pthread_rwlock_t* l)
+    {
+        BusGovernorRealtimeInterpose::check ("pthread_rwlock_wrlock");
+        return BusGovernorRealtimeInterpose::real().rwlockWrite (l);
+    }
+
+    int pthread_cond_wait (pthread_cond_t* c, pthread_mutex_t* m)
+    {
+        BusGovernorRealtimeInterpose::check ("pthread_cond_wait");
+        return BusGovernorRealtimeInterpose::real().condWait (c, m);
+    }
+
+    int pthread_cond_timedwait (pthread_cond_t* c, pthread_mutex_t* m, const timespec* t)
+    {
+        BusGovernorRealtimeInterpose::check ("pthread_cond_timedwait");
+        return BusGovernorRealtimeInterpose::real().condTimedWait (c, m, t);
+    }
+
+    int pthread_join (pthread_t t, void** result)
+    {
+        BusGovernorRealtimeInterpose::check ("pthread_join");
+        return BusGovernorRealtimeInterpose::real().join (t, result);
+    }
+
+    int sem_wait (sem_t* s)
+    {
+        BusGovernorRealtimeInterpose::check ("sem_wait");
+        return BusGovernorRealtimeInterpose::real().semWait (s);
+    }
+
+    //==============================================================================
+    int nanosleep (const timespec* t, timespec* rem)
+    {
+        BusGovernorRealtimeInterpose::check ("nanosleep");
+        return BusGovernorRealtimeInterpose::real().nanosleep (t, rem);
+    }
+
+    int clock_nanosleep (clockid_t c, int flags, const timespec* t, timespec* rem)
+    {
+        BusGovernorRealtimeInterpose::check ("clock_nanosleep");
+        return BusGovernorRealtimeInterpose::real().clockNanosleep (c, flags, t, rem);
+    }
+
+    int usleep (useconds_t us)
+    {
+        BusGovernorRealtimeInterpose::check ("usleep");
+        return BusGovernorRealtimeInterpose::real().usleep (us);
+    }
+
+    unsigned sleep (unsigned s)
+    {
+        BusGovernorRealtimeInterpose::check ("sleep");
+        return BusGovernorRealtimeInterpose::real().sleep (s);
+    }
+
+    ssize_t read (int fd, void* buf, size_t n)
+    {
+        BusGovernorRealtimeInterpose::check ("read");
+        return BusGovernorRealtimeInterpose::real().read (fd, buf, n);
+    }
+
+    ssize_t write (int fd, const void* buf, size_t n)
+    {
+        BusGovernorRealtimeInterpose::check ("write");
+        return BusGovernorRealtimeInterpose::real().write (fd, buf, n);
+    }
+
+    int poll (pollfd* fds, nfds_t n, int timeout)
+    {
+        BusGovernorRealtimeInterpose::check ("poll");
+        return BusGovernorRealtimeInterpose::real().poll (fds, n, timeout);
+    }
+
+    int select (int n, fd_set* r, fd_set* w, fd_set* e, timeval* timeout)
+    {
+        BusGovernorRealtimeInterpose::check ("select");
+        return BusGovernorRealtimeInterpose::real().select (n, r, w, e, timeout);
+    }
+}
+
+#endif
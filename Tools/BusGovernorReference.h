@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    BusGovernorReference - the original scalar processBlock loop, frozen.
+
+    This is the per-sample governor exactly as BusGovernorAudioProcessor
+    shipped it before the DSP moved into BusGovernorCore: std::pow, float
+    throughout, one sample at a time, parameters constant per block. It is
+    the yardstick every optimized kernel is measured against, so do not
+    change it; optimize BusGovernorCore instead.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+//==============================================================================
+class BusGovernorReference
+{
+public:
+    float a = 1.0f;
+    float b = 1.0f;
+
+    float pressure = 0.27f;
+    float drive    = 5.8f;
+    float volume   = 1.0f;
+
+    void reset() noexcept       { a = b = 1.0f; }
+
+    // ch1 may be nullptr (mono: the detector sees l + l)
+    void process (float* ch0, float* ch1, int numSamples) noexcept
+    {
+        constexpr float eps = 1.0e-12f;
+        constexpr float shapeK = 6.0f;
+
+        for (int s = 0; s < numSamples; ++s)
+        {
+            const float l = ch0[s];
+            const float r = (ch1 != nullptr) ? ch1[s] : l;
+
+            // Detector from INPUT only
+            const float det = std::abs (l + r);
+
+            // ---- BusGovernor core ----
+            const float aSafe = std::max (a, eps);
+            a = (1.0f - 0.012f) * (a + std::abs (b - a))
+              + 0.012f * std::abs (b * det * det * drive) / (aSafe * aSafe);
+
+            const float bSafe = std::max (b, eps);
+            const float base  = std::max (b + std::abs (a - b), eps);
+            const float expo  = a / bSafe;
+            b = (1.0f - 0.008f) * (a + std::abs (b - a))
+              + 0.008f * std::abs (std::pow (base, expo));
+
+            // ---- Base output: NO makeup inside ----
+            const float invb = 1.0f / std::max (b, eps);
+            float outL = l * invb;   // out = in/b
+            float outR = r * invb;
+
+            // ---- Pressure A: shaped delta between out and out/b ----
+            const float pressedL = outL * invb;   // out/b
+            const float pressedR = outR * invb;
+
+            const float dL = pressedL - outL;
+            const float dR = pressedR - outR;
+
+            const float dLs = dL / (1.0f + shapeK * std::abs (dL));
+            const float dRs = dR / (1.0f + shapeK * std::abs (dR));
+
+            outL += pressure * dLs;
+            outR += pressure * dRs;
+
+            // ---- Post output Volume (pure trim) ----
+            outL *= volume;
+            outR *= volume;
+
+            ch0[s] = outL;
+            if (ch1 != nullptr)
+                ch1[s] = outR;
+        }
+    }
+};
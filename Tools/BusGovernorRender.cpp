@@ -0,0 +1,428 @@
+/*
+  ==============================================================================
+
+    BusGovernorRender - offline batch renderer.
+
+    Runs WAV/AIFF files through BusGovernorAudioProcessor itself (headless,
+    no editor), so the result is what processBlock produces in a host:
+    same parameters, smoothing, oversampling, lookahead and multiband. The
+    plugin's reported latency is compensated, so every output lines up
+    with its input and has the same length, channel count, rate and bit
+    depth.
+
+    Files are read through memory-mapped readers where the format supports
+    them (streamed otherwise) and written through a large output buffer,
+    in blocks of --block frames. Each worker thread owns one processor
+    instance and pulls the next file from a shared queue, largest file
+    first, so long files start early and the tail stays short.
+
+    Build as a JUCE console app linked against the plugin's shared code
+    (with CMake: juce_add_console_app, then target_link_libraries against
+    the juce_add_plugin target), with juce_audio_formats and juce_dsp.
+
+    Usage:
+
+        BusGovernorRender [options] <file or directory>...
+
+        --out <dir>          output directory (required); directory inputs
+                             keep their relative paths below it
+        --preset <file>      parameter state: the plugin's state XML, or
+                             the binary blob from getStateInformation
+        --set <id>=<value>   one parameter, as the host would display it
+                             (e.g. drive=8.5, oversample=4x, bands=3);
+                             repeatable, applied after --preset
+        --threads <n>        worker threads (default: all cores)
+        --block <n>          frames per processBlock call (default 4096)
+        --double             process in double precision
+        --suffix <text>      appended to output file names
+
+    Prints per file and aggregate throughput as multiples of real time.
+    Exits with 1 if any file failed.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "../PluginProcessor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//==============================================================================
+namespace
+{
+    struct Options
+    {
+        juce::File outDir;
+        juce::File preset;
+        juce::StringPairArray parameters;   // id -> display text
+        juce::String suffix;
+        int threads = 0;
+        int blockSize = 4096;
+        bool doublePrecision = false;
+    };
+
+    struct Job
+    {
+        juce::File input, output;
+        juce::int64 size = 0;
+    };
+
+    struct Result
+    {
+        bool ok = false;
+        double audioSeconds = 0.0, wallSeconds = 0.0;
+        juce::String error;
+    };
+
+    std::mutex printLock;
+
+    //==============================================================================
+    // Preset first, then the individual --set values
+    juce::String applyParameters (BusGovernorAudioProcessor& processor, const Options& options)
+    {
+        if (options.preset != juce::File())
+        {
+            if (auto xml = juce::XmlDocument::parse (options.preset))
+            {
+                if (! xml->hasTagName (processor.apvts.state.getType()))
+                    return "preset " + options.preset.getFullPathName() + " is not a BusGovernor state";
+
+                processor.apvts.replaceState (juce::ValueTree::fromXml (*xml));
+            }
+            else
+            {
+                juce::MemoryBlock data;
+
+                if (! options.preset.loadFileAsData (data) || data.isEmpty())
+                    return "cannot read preset " + options.preset.getFullPathName();
+
+                processor.setStateInformation (data.getData(), (int) data.getSize());
+            }
+        }
+
+        for (const auto& id : options.parameters.getAllKeys())
+        {
+            auto* param = processor.apvts.getParameter (id);
+
+            if (param == nullptr)
+                return "unknown parameter '" + id + "'";
+
+            param->setValueNotifyingHost (param->getValueForText (options.parameters[id]));
+        }
+
+        return {};
+    }
+
+    // Memory-mapped where the format can, streamed otherwise
+    std::unique_ptr<juce::AudioFormatReader> openReader (juce::AudioFormatManager& formats, const juce::File& file)
+    {
+        if (auto* format = formats.findFormatForFileExtension (file.getFileExtension()))
+        {
+            std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped (format->createMemoryMappedReader (file));
+
+            if (mapped != nullptr && mapped->mapEntireFile())
+                return mapped;
+        }
+
+        return std::unique_ptr<juce::AudioFormatReader> (formats.createReaderFor (file));
+    }
+
+    //==============================================================================
+    // One block in place; in double precision it goes through a double copy
+    void processBlock (BusGovernorAudioProcessor& processor, juce::AudioBuffer<float>& block,
+                       juce::AudioBuffer<double>& doubleBlock, bool doublePrecision)
+    {
+        juce::MidiBuffer midi;
+
+        if (! doublePrecision)
+        {
+            processor.processBlock (block, midi);
+            return;
+        }
+
+        doubleBlock.makeCopyOf (block, true);
+        processor.processBlock (doubleBlock, midi);
+        block.makeCopyOf (doubleBlock, true);
+    }
+
+    Result renderFile (BusGovernorAudioProcessor& processor, juce::AudioFormatManager& formats,
+                       const Job& job, const Options& options)
+    {
+        Result result;
+        const auto start = juce::Time::getMillisecondCounterHiRes();
+
+        auto reader = openReader (formats, job.input);
+
+        if (reader == nullptr)
+        {
+            result.error = "cannot read";
+            return result;
+        }
+
+        const int numChannels = (int) reader->numChannels;
+        const double sampleRate = reader->sampleRate;
+        const juce::int64 numFrames = reader->lengthInSamples;
+
+        // ---- Processor: file layout and rate ----
+        processor.releaseResources();
+
+        const auto channelSet = juce::AudioChannelSet::canonicalChannelSet (numChannels);
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add (channelSet);
+        layout.outputBuses.add (channelSet);
+
+        if (! processor.setBusesLayout (layout))
+        {
+            result.error = "unsupported channel count " + juce::String (numChannels);
+            return result;
+        }
+
+        processor.setProcessingPrecision (options.doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                                  : juce::AudioProcessor::singlePrecision);
+        processor.setRateAndBufferSizeDetails (sampleRate, options.blockSize);
+        processor.prepareToPlay (sampleRate, options.blockSize);
+
+        // ---- Writer: same format, rate, channels and bit depth ----
+        auto* format = formats.findFormatForFileExtension (job.output.getFileExtension());
+        job.output.getParentDirectory().createDirectory();
+        job.output.deleteFile();
+
+        auto stream = std::make_unique<juce::FileOutputStream> (job.output, 1 << 20);
+
+        if (format == nullptr || stream->failedToOpen())
+        {
+            result.error = "cannot write " + job.output.getFullPathName();
+            return result;
+        }
+
+        std::unique_ptr<juce::AudioFormatWriter> writer (format->createWriterFor (stream.get(), sampleRate,
+                                                                                  (unsigned int) numChannels,
+                                                                                  (int) reader->bitsPerSample,
+                                                                                  reader->metadataValues, 0));
+        if (writer == nullptr)
+        {
+            result.error = "cannot write " + juce::String ((int) reader->bitsPerSample) + "-bit " + format->getFormatName();
+            return result;
+        }
+
+        stream.release();   // owned by the writer now
+
+        // ---- Render, dropping the first `latency` output frames and
+        // flushing the tail with silence ----
+        const int latency = processor.getLatencySamples();
+
+        juce::AudioBuffer<float> block (numChannels, options.blockSize);
+        juce::AudioBuffer<double> doubleBlock;
+        juce::int64 readPos = 0, written = 0;
+        int toSkip = latency;
+
+        while (written < numFrames)
+        {
+            const int n = options.blockSize;
+            const int fromFile = (int) juce::jlimit ((juce::int64) 0, (juce::int64) n, numFrames - readPos);
+
+            block.clear();
+
+            if (fromFile > 0)
+                reader->read (&block, 0, fromFile, readPos, true, true);
+
+            readPos += fromFile;
+
+            processBlock (processor, block, doubleBlock, options.doublePrecision);
+
+            const int skip = juce::jmin (toSkip, n);
+            toSkip -= skip;
+
+            const int keep = (int) juce::jmin ((juce::int64) (n - skip), numFrames - written);
+
+            if (keep > 0 && ! writer->writeFromAudioSampleBuffer (block, skip, keep))
+            {
+                result.error = "write failed";
+                return result;
+            }
+
+            written += juce::jmax (0, keep);
+        }
+
+        writer.reset();   // flushes
+
+        result.ok = true;
+        result.audioSeconds = (double) numFrames / sampleRate;
+        result.wallSeconds = (juce::Time::getMillisecondCounterHiRes() - start) * 0.001;
+        return result;
+    }
+
+    //==============================================================================
+    bool isAudioFile (const juce::File& f)
+    {
+        return f.hasFileExtension ("wav;aif;aiff");
+    }
+
+    void collectJobs (const juce::File& input, const Options& options, std::vector<Job>& jobs)
+    {
+        auto outputFor = [&options] (const juce::String& relativePath)
+        {
+            const auto target = options.outDir.getChildFile (relativePath);
+            return target.getSiblingFile (target.getFileNameWithoutExtension() + options.suffix + target.getFileExtension());
+        };
+
+        if (input.isDirectory())
+        {
+            for (const auto& entry : juce::RangedDirectoryIterator (input, true, "*", juce::File::findFiles))
+                if (isAudioFile (entry.getFile()))
+                    jobs.push_back ({ entry.getFile(), outputFor (entry.getFile().getRelativePathFrom (input)), entry.getFileSize() });
+        }
+        else if (input.existsAsFile())
+        {
+            jobs.push_back ({ input, outputFor (input.getFileName()), input.getSize() });
+        }
+    }
+
+    int usage (const char* name)
+    {
+        std::fprintf (stderr, "usage: %s --out <dir> [--preset file] [--set id=value]... [--threads n] "
+                              "[--block n] [--double] [--suffix text] <file or directory>...\n", name);
+        return 2;
+    }
+}
+
+//==============================================================================
+int main (int argc, char** argv)
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;   // the processor's parameter tree wants a message manager
+
+    Options options;
+    juce::StringArray inputs;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String arg (argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--out" && hasValue)             options.outDir = juce::File::getCurrentWorkingDirectory().getChildFile (argv[++i]);
+        else if (arg == "--preset" && hasValue)     options.preset = juce::File::getCurrentWorkingDirectory().getChildFile (argv[++i]);
+        else if (arg == "--threads" && hasValue)    options.threads = juce::jmax (1, juce::String (argv[++i]).getIntValue());
+        else if (arg == "--block" && hasValue)      options.blockSize = juce::jmax (16, juce::String (argv[++i]).getIntValue());
+        else if (arg == "--suffix" && hasValue)     options.suffix = argv[++i];
+        else if (arg == "--double")                 options.doublePrecision = true;
+        else if (arg == "--set" && hasValue)
+        {
+            const juce::String kv (argv[++i]);
+
+            if (! kv.containsChar ('='))
+                return usage (argv[0]);
+
+            options.parameters.set (kv.upToFirstOccurrenceOf ("=", false, false).trim(),
+                                    kv.fromFirstOccurrenceOf ("=", false, false).trim());
+        }
+        else if (arg.startsWith ("--"))
+            return usage (argv[0]);
+        else
+            inputs.add (argv[i]);
+    }
+
+    if (options.outDir == juce::File() || inputs.isEmpty())
+        return usage (argv[0]);
+
+    std::vector<Job> jobs;
+
+    for (const auto& in : inputs)
+        collectJobs (juce::File::getCurrentWorkingDirectory().getChildFile (in), options, jobs);
+
+    for (const auto& job : jobs)
+    {
+        if (job.output == job.input)
+        {
+            std::fprintf (stderr, "refusing to overwrite %s (use another --out or a --suffix)\n",
+                          job.input.getFullPathName().toRawUTF8());
+            return 2;
+        }
+    }
+
+    if (jobs.empty())
+    {
+        std::fprintf (stderr, "no WAV/AIFF files found\n");
+        return 2;
+    }
+
+    // Largest first, so the last files to start are the short ones
+    std::sort (jobs.begin(), jobs.end(), [] (const Job& a, const Job& b) { return a.size > b.size; });
+
+    const int numThreads = juce::jmin ((int) jobs.size(),
+                                       options.threads > 0 ? options.threads : juce::SystemStats::getNumCpus());
+
+    // One processor per worker, set up here on the message thread
+    std::vector<std::unique_ptr<BusGovernorAudioProcessor>> processors;
+
+    for (int t = 0; t < numThreads; ++t)
+    {
+        processors.push_back (std::make_unique<BusGovernorAudioProcessor>());
+
+        const auto error = applyParameters (*processors.back(), options);
+
+        if (error.isNotEmpty())
+        {
+            std::fprintf (stderr, "%s\n", error.toRawUTF8());
+            return 2;
+        }
+    }
+
+    std::vector<Result> results (jobs.size());
+    std::atomic<size_t> nextJob { 0 };
+
+    const auto wallStart = juce::Time::getMillisecondCounterHiRes();
+
+    auto worker = [&] (int index)
+    {
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        for (size_t j; (j = nextJob.fetch_add (1)) < jobs.size();)
+        {
+            results[j] = renderFile (*processors[(size_t) index], formats, jobs[j], options);
+
+            const std::lock_guard<std::mutex> lock (printLock);
+            const auto& r = results[j];
+
+            if (r.ok)
+                std::printf ("%8.1fx  %7.1f s  %s\n", r.audioSeconds / juce::jmax (1.0e-9, r.wallSeconds),
+                             r.audioSeconds, jobs[j].output.getFullPathName().toRawUTF8());
+            else
+                std::printf ("  FAILED            %s: %s\n", jobs[j].input.getFullPathName().toRawUTF8(), r.error.toRawUTF8());
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < numThreads; ++t)
+        threads.emplace_back (worker, t);
+
+    for (auto& t : threads)
+        t.join();
+
+    const double wall = (juce::Time::getMillisecondCounterHiRes() - wallStart) * 0.001;
+
+    double audio = 0.0, busy = 0.0;
+    int failed = 0;
+
+    for (const auto& r : results)
+    {
+        audio += r.audioSeconds;
+        busy  += r.wallSeconds;
+        failed += r.ok ? 0 : 1;
+    }
+
+    std::printf ("\n%d files, %.1f s of audio in %.2f s on %d threads: %.1fx real time (%.1fx per thread)%s\n",
+                 (int) jobs.size(), audio, wall, numThreads,
+                 audio / juce::jmax (1.0e-9, wall), audio / juce::jmax (1.0e-9, busy),
+                 failed > 0 ? (", " + juce::String (failed) + " failed").toRawUTF8() : "");
+
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+    Deterministic test signals for the BusGovernor tools (benchmark and
+    equivalence check). Fixed seeds, so every run sees the same samples.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+//==============================================================================
+namespace BusGovernorStimuli
+{
+    constexpr double pi = 3.14159265358979323846;
+
+    enum class Stimulus { silence, sine, pink, drums, sweep, hot };
+
+    inline const char* getName (Stimulus s)
+    {
+        switch (s)
+        {
+            case Stimulus::silence: return "silence";
+            case Stimulus::sine:    return "sine";
+            case Stimulus::pink:    return "pink";
+            case Stimulus::drums:   return "drums";
+            case Stimulus::sweep:   return "sweep";
+            case Stimulus::hot:     return "hot";
+        }
+
+        return "?";
+    }
+
+    // Pink noise with Paul Kellet's refined filter, scaled by gain
+    inline void fillPink (std::vector<float>& x, std::mt19937& rng, float gain)
+    {
+        std::uniform_real_distribution<float> white (-1.0f, 1.0f);
+        float b0 = 0, b1 = 0, b2 = 0, b3 = 0, b4 = 0, b5 = 0, b6 = 0;
+
+        for (auto& v : x)
+        {
+            const float w = white (rng);
+            b0 = 0.99886f * b0 + w * 0.0555179f;
+            b1 = 0.99332f * b1 + w * 0.0750759f;
+            b2 = 0.96900f * b2 + w * 0.1538520f;
+            b3 = 0.86650f * b3 + w * 0.3104856f;
+            b4 = 0.55000f * b4 + w * 0.5329522f;
+            b5 = -0.7616f * b5 - w * 0.0168980f;
+            v  = gain * (b0 + b1 + b2 + b3 + b4 + b5 + b6 + w * 0.5362f);
+            b6 = w * 0.115926f;
+        }
+    }
+
+    // One buffer per channel
+    inline std::vector<std::vector<float>> make (Stimulus type, int numChannels, double sampleRate, int numSamples)
+    {
+        std::vector<std::vector<float>> out ((size_t) numChannels, std::vector<float> ((size_t) numSamples, 0.0f));
+
+        std::mt19937 rng (1234);
+        std::uniform_real_distribution<float> white (-1.0f, 1.0f);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto& x = out[(size_t) ch];
+
+            switch (type)
+            {
+                case Stimulus::silence:
+                    break;
+
+                case Stimulus::sine:    // 997 Hz at -6 dBFS, right channel a quarter cycle later
+                    for (int i = 0; i < numSamples; ++i)
+                        x[(size_t) i] = 0.5f * (float) std::sin (2.0 * pi * 997.0 * i / sampleRate + ch * 0.5 * pi);
+                    break;
+
+                case Stimulus::pink:    // about -12 dBFS rms
+                    fillPink (x, rng, 0.05f);
+                    break;
+
+                case Stimulus::hot:     // pink about +4 dBFS peak-heavy, well past full scale
+                    fillPink (x, rng, 0.4f);
+                    break;
+
+                case Stimulus::sweep:   // 20 Hz -> 20 kHz log sweep at -3 dBFS over the whole buffer
+                {
+                    const double len = numSamples / sampleRate;
+                    const double k   = std::log (20000.0 / 20.0);
+
+                    for (int i = 0; i < numSamples; ++i)
+                    {
+                        const double t = i / sampleRate;
+                        const double phase = 2.0 * pi * 20.0 * len / k * (std::exp (t / len * k) - 1.0);
+                        x[(size_t) i] = 0.7f * (float) std::sin (phase + ch * 0.5 * pi);
+                    }
+                    break;
+                }
+
+                case Stimulus::drums:   // 120 BPM: kick on 1/3, snare on 2/4, closed hats on eighths
+                {
+                    const int beat = (int) (sampleRate * 0.5);
+
+                    for (int i = 0; i < numSamples; ++i)
+                    {
+                        const int posInBar = i % (beat * 4);
+                        const int beatIdx  = posInBar / beat;
+                        const double t     = (posInBar % beat) / sampleRate;
+                        const double tHat  = (posInBar % (beat / 2)) / sampleRate;
+
+                        double v = 0.0;
+
+                        if (beatIdx % 2 == 0)
+                            v += 0.9 * std::exp (-t * 18.0) * std::sin (2.0 * pi * (50.0 * t + 60.0 * (1.0 - std::exp (-t * 30.0)) / 30.0));
+                        else
+                            v += 0.5 * std::exp (-t * 25.0) * (0.6 * white (rng) + 0.4 * std::sin (2.0 * pi * 190.0 * t));
+
+                        v += 0.15 * std::exp (-tHat * 120.0) * white (rng);
+
+                        x[(size_t) i] = (float) v;
+                    }
+                    break;
+                }
+            }
+        }
+
+        return out;
+    }
+}
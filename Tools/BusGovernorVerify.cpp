@@ -0,0 +1,648 @@
+/*
+  ==============================================================================
+
+    BusGovernorVerify - numerical equivalence of the optimized kernels
+    against the frozen reference loop (BusGovernorReference.h).
+
+    Every kernel runs the same corpus as the reference: a set of stimuli,
+    mono and stereo, a drive x pressure grid, and the base rate and
+    oversampled rates (the stimuli generated at 2x/4x the rate, in blocks
+    2x/4x as long, as the plugin runs the core inside oversampling; the
+    half-band filters are JUCE's and not part of this check). Per kernel
+    it reports the worst case over the corpus of:
+
+        max error     peak |kernel - reference| in dBFS
+        rms error     rms of the difference in dBFS
+        b divergence  max |b - bRef| / bRef, sampled at every block end,
+                      plus when it first crossed the tolerance and whether
+                      it keeps growing (last tenth of the run more than
+                      twice the tenth around the middle)
+
+    The ramp kernels move the parameters every other block, the reference
+    along with them one sample at a time. The multiband kernels are checked
+    against their own reference: the crossover tree sample by sample
+    (BusGovernorCrossoverT::split/allpass) and one frozen loop per band.
+
+    "Exact" kernels must match the reference bit for bit. The others pass if
+    all three stay within their tolerances, which default to the values
+    below and can be overridden for every inexact kernel from the command
+    line.
+
+    No JUCE needed; from the repository root:
+
+        c++ -O3 -std=c++17 -o BusGovernorVerify Tools/BusGovernorVerify.cpp
+
+    Options:
+
+        --kernel <name>      only this kernel (repeatable)
+        --quick              reduced corpus
+        --seconds <s>        audio per run (default 5)
+        --block <n>          block size (default 512)
+        --max-db <dB>        max error tolerance for inexact kernels
+        --rms-db <dB>        rms error tolerance for inexact kernels
+        --b-div <x>          b divergence tolerance for inexact kernels
+        --verbose            print every run, not just the summary
+
+    Exits with 1 if any kernel fails.
+
+  ==============================================================================
+*/
+
+#include "../BusGovernorBank.h"
+#include "../BusGovernorCore.h"
+#include "../BusGovernorLookahead.h"
+#include "../BusGovernorMultiband.h"
+#include "BusGovernorReference.h"
+#include "BusGovernorStimuli.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+//==============================================================================
+namespace
+{
+    using BusGovernorStimuli::Stimulus;
+
+    struct Setting
+    {
+        float drive, pressure;
+    };
+
+    // One kernel under test, fed the same blocks as the reference
+    struct Runner
+    {
+        virtual ~Runner() = default;
+        virtual void prepare (const Setting&, double sampleRate) = 0;
+        virtual void process (float* l, float* r, int n) = 0;
+        virtual double getB() const = 0;
+
+        // Parameters to ramp to across the next process() call (ramp kernels)
+        virtual void setTarget (const BusGovernorParameters&) {}
+    };
+
+    //==============================================================================
+    // The frozen loop. While ramping it runs one sample at a time, on the
+    // parameters the core gives that sample (k + 1 steps of the block's ramp).
+    struct ReferenceRunner : Runner
+    {
+        void prepare (const Setting& s, double) override
+        {
+            reference.reset();
+            params = target = { s.pressure, s.drive, 1.0f };
+        }
+
+        void setTarget (const BusGovernorParameters& p) override    { target = p; }
+
+        void process (float* l, float* r, int n) override
+        {
+            const bool ramping = target.pressure != params.pressure || target.drive != params.drive
+                              || target.volume != params.volume;
+
+            const float inc = 1.0f / (float) n;
+            const float dPressure = (target.pressure - params.pressure) * inc;
+            const float dDrive    = (target.drive    - params.drive)    * inc;
+            const float dVolume   = (target.volume   - params.volume)   * inc;
+
+            for (int s = 0; s < n; s += ramping ? 1 : n)
+            {
+                const float k = (float) (s + 1);
+
+                reference.pressure = ramping ? params.pressure + dPressure * k : params.pressure;
+                reference.drive    = ramping ? params.drive    + dDrive    * k : params.drive;
+                reference.volume   = ramping ? params.volume   + dVolume   * k : params.volume;
+
+                reference.process (l + s, r != nullptr ? r + s : nullptr, ramping ? 1 : n);
+            }
+
+            params = target;
+        }
+
+        double getB() const override    { return reference.b; }
+
+        BusGovernorReference reference;
+        BusGovernorParameters params, target;
+    };
+
+    // Band j of the multiband kernels: drive and pressure spread around the
+    // setting, so every band has its own state
+    BusGovernorParameters bandParameters (const Setting& s, int band)
+    {
+        return { s.pressure * (1.0f - 0.2f * (float) band), s.drive * (1.0f + 0.5f * (float) band), 1.0f };
+    }
+
+    constexpr float crossoverHz[] = { 150.0f, 1500.0f, 6000.0f };
+
+    // The multiband reference: split, govern and sum one sample at a time.
+    // Band k leaves crossover k's split; the bands below it pass its allpass.
+    // Its b is the sum over the bands.
+    template <int NumBands>
+    struct MultibandReferenceRunner : Runner
+    {
+        using Crossover = BusGovernorCrossoverT<float>;
+
+        void prepare (const Setting& s, double sampleRate) override
+        {
+            for (int k = 0; k < NumBands - 1; ++k)
+            {
+                crossovers[k].setCutoff (crossoverHz[k], sampleRate);
+                crossovers[k].reset();
+            }
+
+            for (auto& perBand : allpasses)
+                for (auto& perCrossover : perBand)
+                    for (auto& st : perCrossover)
+                        st = {};
+
+            for (int j = 0; j < NumBands; ++j)
+            {
+                const auto p = bandParameters (s, j);
+                bands[j].reset();
+                bands[j].pressure = p.pressure;
+                bands[j].drive    = p.drive;
+            }
+        }
+
+        void process (float* l, float* r, int n) override
+        {
+            const int numChannels = r != nullptr ? 2 : 1;
+            float* io[] = { l, r };
+
+            for (int s = 0; s < n; ++s)
+            {
+                float x[NumBands][2] = {};
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    float rest = io[ch][s];
+
+                    for (int k = 0; k < NumBands - 1; ++k)
+                    {
+                        float high;
+                        x[k][ch] = crossovers[k].split (rest, high, ch);
+                        rest = high;
+
+                        for (int j = 0; j < k; ++j)
+                            x[j][ch] = crossovers[k].allpass (x[j][ch], allpasses[j][k][ch]);
+                    }
+
+                    x[NumBands - 1][ch] = rest;
+                }
+
+                for (int j = 0; j < NumBands; ++j)
+                    bands[j].process (&x[j][0], r != nullptr ? &x[j][1] : nullptr, 1);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    float sum = x[0][ch];
+
+                    for (int j = 1; j < NumBands; ++j)
+                        sum += x[j][ch];
+
+                    io[ch][s] = sum;
+                }
+            }
+        }
+
+        double getB() const override
+        {
+            double sum = 0.0;
+
+            for (const auto& band : bands)
+                sum += band.b;
+
+            return sum;
+        }
+
+        Crossover crossovers[NumBands > 1 ? NumBands - 1 : 1];
+        typename Crossover::AllpassState allpasses[NumBands][NumBands][2];
+        BusGovernorReference bands[NumBands];
+    };
+
+    //==============================================================================
+    template <typename Core>
+    struct CoreRunner : Runner
+    {
+        explicit CoreRunner (int interval) : controlInterval (interval) {}
+
+        void prepare (const Setting& s, double) override
+        {
+            core.reset();
+            core.setParameters ({ s.pressure, s.drive, 1.0f });
+            core.setControlInterval (controlInterval);
+        }
+
+        void setTarget (const BusGovernorParameters& p) override    { core.setTargetParameters (p); }
+        void process (float* l, float* r, int n) override          { core.process (l, r, n); }
+        double getB() const override                          { return core.getState().b; }
+
+        Core core;
+        int controlInterval;
+    };
+
+    struct DoubleRunner : Runner
+    {
+        void prepare (const Setting& s, double) override
+        {
+            core.reset();
+            core.setParameters ({ s.pressure, s.drive, 1.0f });
+        }
+
+        void process (float* l, float* r, int n) override
+        {
+            ld.assign (l, l + n);
+            rd.assign (r != nullptr ? r : l, (r != nullptr ? r : l) + n);
+
+            core.process (ld.data(), r != nullptr ? rd.data() : nullptr, n);
+
+            std::transform (ld.begin(), ld.end(), l, [] (double v) { return (float) v; });
+
+            if (r != nullptr)
+                std::transform (rd.begin(), rd.end(), r, [] (double v) { return (float) v; });
+        }
+
+        double getB() const override    { return core.getState().b; }
+
+        BusGovernorCoreDouble core;
+        std::vector<double> ld, rd;
+    };
+
+    // Multichannel entry point with the weights that mimic mono/stereo
+    struct LinkedRunner : Runner
+    {
+        explicit LinkedRunner (bool withLookahead) : lookahead (withLookahead) {}
+
+        void prepare (const Setting& s, double) override
+        {
+            core.reset();
+            core.setParameters ({ s.pressure, s.drive, 1.0f });
+            delay.prepare (2, 0);
+        }
+
+        void setTarget (const BusGovernorParameters& p) override    { core.setTargetParameters (p); }
+
+        void process (float* l, float* r, int n) override
+        {
+            float* channels[] = { l, r };
+            const float weights[] = { r != nullptr ? 1.0f : 2.0f, 1.0f };
+            const int numChannels = r != nullptr ? 2 : 1;
+
+            if (lookahead)
+            {
+                detector.resize ((size_t) n);
+                delay.process (channels, weights, numChannels, detector.data(), n);
+                core.process (channels, numChannels, detector.data(), n);
+            }
+            else
+            {
+                core.process (channels, weights, numChannels, n);
+            }
+        }
+
+        double getB() const override    { return core.getState().b; }
+
+        BusGovernorCore core;
+        BusGovernorLookahead delay;
+        std::vector<float> detector;
+        bool lookahead;
+    };
+
+    struct BankRunner : Runner
+    {
+        void prepare (const Setting& s, double) override
+        {
+            bank.prepare (1);
+            bank.setLaneParameters (0, { s.pressure, s.drive, 1.0f });
+        }
+
+        void setTarget (const BusGovernorParameters& p) override    { bank.setLaneTargetParameters (0, p); }
+
+        void process (float* l, float* r, int n) override
+        {
+            float* left[]  = { l };
+            float* right[] = { r };
+            bank.process (left, right, n);
+        }
+
+        double getB() const override    { return bank.getLaneState (0).b; }
+
+        BusGovernorBank bank;
+    };
+
+    // As the plugin instantiates it (BusGovernorPow); b summed over the bands
+    template <int NumBands>
+    struct MultibandRunner : Runner
+    {
+        void prepare (const Setting& s, double sampleRate) override
+        {
+            multiband.prepare (sampleRate);
+            multiband.setNumBands (NumBands);
+
+            for (int k = 0; k < NumBands - 1; ++k)
+                multiband.setCrossover (k, crossoverHz[k]);
+
+            for (int j = 0; j < NumBands; ++j)
+                multiband.setBandParameters (j, bandParameters (s, j));
+
+            multiband.reset();
+        }
+
+        void process (float* l, float* r, int n) override    { multiband.process (l, r, n); }
+
+        double getB() const override
+        {
+            double sum = 0.0;
+
+            for (int j = 0; j < NumBands; ++j)
+                sum += multiband.getBandState (j).b;
+
+            return sum;
+        }
+
+        BusGovernorMultibandT<BusGovernorPow> multiband;
+    };
+
+    //==============================================================================
+    using RunnerFactory = std::function<std::unique_ptr<Runner>()>;
+
+    struct Kernel
+    {
+        std::string name;
+        bool exact;
+        double maxErrorDb, rmsErrorDb, bDivergence;   // tolerances when inexact
+        RunnerFactory create;
+        bool ramped = false;                          // parameters move every other block
+        RunnerFactory reference = [] { return std::unique_ptr<Runner> (new ReferenceRunner()); };
+    };
+
+    // Default tolerances sit a few dB above the worst case measured over the
+    // full corpus at 5 s per run. "double" is compared with the float
+    // reference, so its figures are the reference's own rounding error.
+    std::vector<Kernel> allKernels()
+    {
+        using FastCore = BusGovernorCoreT<BusGovernorFastPow>;
+
+        auto core = [] (int interval)   { return [interval] { return std::unique_ptr<Runner> (new CoreRunner<BusGovernorCore> (interval)); }; };
+        auto fast = [] (int interval)   { return [interval] { return std::unique_ptr<Runner> (new CoreRunner<FastCore> (interval)); }; };
+        auto linked = [] (bool lookahead)   { return [lookahead] { return std::unique_ptr<Runner> (new LinkedRunner (lookahead)); }; };
+        auto bank = [] { return std::unique_ptr<Runner> (new BankRunner()); };
+
+        auto multiband = [] (Kernel k, auto bands)
+        {
+            constexpr int numBands = decltype (bands)::value;
+            k.create    = [] { return std::unique_ptr<Runner> (new MultibandRunner<numBands>()); };
+            k.reference = [] { return std::unique_ptr<Runner> (new MultibandReferenceRunner<numBands>()); };
+            return k;
+        };
+
+        // With BUSGOVERNOR_FAST_MATH the default engine is the fast pow, so the
+        // plugin's own paths are held to the fastpow tolerances instead
+        constexpr bool exactDefault = BUSGOVERNOR_FAST_MATH == 0;
+
+        return {
+            { "core",         exactDefault, -95, -105, 1.0e-4,   core (1) },
+            { "linked",       exactDefault, -95, -105, 1.0e-4,   linked (false) },
+            { "lookahead0",   exactDefault, -95, -105, 1.0e-4,   linked (true) },
+            { "ramp",         exactDefault, -95, -105, 1.0e-4,   core (1), true },
+            { "linkedramp",   exactDefault, -95, -105, 1.0e-4,   linked (false), true },
+            { "fastpow",      false, -95, -105, 1.0e-4,   fast (1) },
+            { "bank",         false, -70, -80,  2.0e-3,   bank },
+            { "bankramp",     false, -70, -80,  2.0e-3,   bank, true },
+            multiband ({ "multiband2", false, -65, -80, 2.0e-3, {} }, std::integral_constant<int, 2>()),
+            multiband ({ "multiband4", false, -65, -80, 2.0e-3, {} }, std::integral_constant<int, 4>()),
+            { "double",       false, -65, -75,  3.0e-3,   [] { return std::unique_ptr<Runner> (new DoubleRunner()); } },
+            { "eco4",         false, -50, -80,  1.0e-2,   core (4) },
+            { "eco8",         false, -43, -75,  1.5e-2,   core (8) },
+            { "eco16",        false, -33, -70,  3.0e-2,   core (16) },
+            { "eco32",        false, -27, -64,  5.0e-2,   core (32) },
+        };
+    }
+
+    //==============================================================================
+    struct Metrics
+    {
+        double maxErrorDb = -std::numeric_limits<double>::infinity();
+        double rmsErrorDb = -std::numeric_limits<double>::infinity();
+        double bDivergence = 0.0;
+        double firstExceedSeconds = -1.0;   // b divergence over tolerance; -1 = never
+        bool growing = false;
+        bool identical = true;
+    };
+
+    double toDb (double x)      { return x > 0.0 ? 20.0 * std::log10 (x) : -std::numeric_limits<double>::infinity(); }
+
+    Metrics compare (const Kernel& k, Stimulus stimulus, int numChannels, const Setting& setting,
+                     double sampleRate, double seconds, int blockSize)
+    {
+        const int numSamples = (int) (seconds * sampleRate);
+        const auto source = BusGovernorStimuli::make (stimulus, numChannels, sampleRate, numSamples);
+
+        auto ref = source;
+        auto alt = source;
+
+        auto reference = k.reference();
+        auto runner = k.create();
+        reference->prepare (setting, sampleRate);
+        runner->prepare (setting, sampleRate);
+
+        // Ramp kernels: out to other parameters, hold, back, hold
+        const BusGovernorParameters base  { setting.pressure, setting.drive, 1.0f },
+                                    moved { 0.5f * setting.pressure + 0.5f, 2.0f * setting.drive, 0.5f };
+
+        std::vector<double> divergence;
+
+        for (int start = 0, block = 0; start < numSamples; start += blockSize, ++block)
+        {
+            const int n = std::min (blockSize, numSamples - start);
+
+            if (k.ramped)
+            {
+                const auto& target = (block % 4 < 2) ? moved : base;
+                reference->setTarget (target);
+                runner->setTarget (target);
+            }
+
+            reference->process (ref[0].data() + start, numChannels > 1 ? ref[1].data() + start : nullptr, n);
+            runner->process    (alt[0].data() + start, numChannels > 1 ? alt[1].data() + start : nullptr, n);
+
+            const double bRef = reference->getB();
+            divergence.push_back (std::abs (runner->getB() - bRef) / std::max (bRef, 1.0e-12));
+        }
+
+        Metrics m;
+        double peak = 0.0, sumSq = 0.0;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float x = ref[(size_t) ch][(size_t) i];
+                const float y = alt[(size_t) ch][(size_t) i];
+
+                m.identical = m.identical && (x == y || (std::isnan (x) && std::isnan (y)));
+
+                const double e = (double) y - (double) x;
+                peak = std::max (peak, std::abs (e));
+                sumSq += e * e;
+            }
+        }
+
+        m.maxErrorDb = toDb (peak);
+        m.rmsErrorDb = toDb (std::sqrt (sumSq / ((double) numSamples * numChannels)));
+
+        const size_t tenth = std::max<size_t> (1, divergence.size() / 10);
+        const size_t mid   = divergence.size() / 2 - std::min (divergence.size() / 2, tenth / 2);
+        double middle = 0.0, late = 0.0;
+
+        for (size_t i = 0; i < divergence.size(); ++i)
+        {
+            m.bDivergence = std::max (m.bDivergence, divergence[i]);
+
+            if (m.firstExceedSeconds < 0.0 && ! k.exact && divergence[i] > k.bDivergence)
+                m.firstExceedSeconds = (double) ((i + 1) * (size_t) blockSize) / sampleRate;
+
+            if (i >= mid && i < mid + tenth)    middle = std::max (middle, divergence[i]);
+            if (i >= divergence.size() - tenth) late   = std::max (late,   divergence[i]);
+        }
+
+        m.growing = late > 2.0 * middle && late > 1.0e-6;
+        return m;
+    }
+}
+
+//==============================================================================
+int main (int argc, char** argv)
+{
+    bool quick = false, verbose = false;
+    double seconds = 5.0;
+    int blockSize = 512;
+    double maxDbOverride = 0.0, rmsDbOverride = 0.0, bDivOverride = -1.0;
+    bool hasMaxDb = false, hasRmsDb = false;
+    std::vector<std::string> only;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--quick")                         quick = true;
+        else if (arg == "--verbose")                  verbose = true;
+        else if (arg == "--kernel" && hasValue)       only.push_back (argv[++i]);
+        else if (arg == "--seconds" && hasValue)      seconds = std::atof (argv[++i]);
+        else if (arg == "--block" && hasValue)        blockSize = std::max (1, std::atoi (argv[++i]));
+        else if (arg == "--max-db" && hasValue)       { maxDbOverride = std::atof (argv[++i]); hasMaxDb = true; }
+        else if (arg == "--rms-db" && hasValue)       { rmsDbOverride = std::atof (argv[++i]); hasRmsDb = true; }
+        else if (arg == "--b-div" && hasValue)        bDivOverride = std::atof (argv[++i]);
+        else
+        {
+            std::fprintf (stderr, "usage: %s [--kernel name]... [--quick] [--seconds s] [--block n] "
+                                  "[--max-db dB] [--rms-db dB] [--b-div x] [--verbose]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    const double sampleRate = 48000.0;
+
+    const std::vector<Stimulus> stimuli = quick
+        ? std::vector<Stimulus> { Stimulus::silence, Stimulus::pink, Stimulus::drums, Stimulus::sweep, Stimulus::hot }
+        : std::vector<Stimulus> { Stimulus::silence, Stimulus::sine, Stimulus::pink,
+                                  Stimulus::drums, Stimulus::sweep, Stimulus::hot };
+
+    // Base rate, then the rates the core runs at inside 2x/4x oversampling
+    const std::vector<int> oversampling = quick ? std::vector<int> { 1, 2 } : std::vector<int> { 1, 2, 4 };
+
+    const std::vector<Setting> settings = quick
+        ? std::vector<Setting> { { 5.8f, 0.27f }, { 24.0f, 1.0f } }
+        : std::vector<Setting> { { 1.0f, 0.0f }, { 1.0f, 0.27f }, { 5.8f, 0.0f }, { 5.8f, 0.27f },
+                                 { 5.8f, 1.0f }, { 12.0f, 0.27f }, { 24.0f, 0.27f }, { 24.0f, 1.0f } };
+
+    int failures = 0;
+
+    std::printf ("%-12s %-6s %12s %12s %12s %10s  %s\n",
+                 "kernel", "", "max err dB", "rms err dB", "b diverg.", "exceeds@", "worst case");
+
+    for (auto k : allKernels())
+    {
+        if (! only.empty() && std::find (only.begin(), only.end(), k.name) == only.end())
+            continue;
+
+        if (! k.exact)
+        {
+            if (hasMaxDb)             k.maxErrorDb  = maxDbOverride;
+            if (hasRmsDb)             k.rmsErrorDb  = rmsDbOverride;
+            if (bDivOverride >= 0.0)  k.bDivergence = bDivOverride;
+        }
+
+        Metrics worst;
+        std::string worstCase;
+        double firstExceed = -1.0;
+        bool growing = false;
+
+        for (auto stimulus : stimuli)
+        {
+            for (int numChannels : { 1, 2 })
+            {
+                for (const auto& setting : settings)
+                {
+                    for (int factor : oversampling)
+                    {
+                        const auto m = compare (k, stimulus, numChannels, setting, sampleRate * factor,
+                                                seconds, blockSize * factor);
+
+                        char name[96];
+                        std::snprintf (name, sizeof (name), "%s/ch%d/drive%.1f/pressure%.2f%s",
+                                       BusGovernorStimuli::getName (stimulus), numChannels, setting.drive, setting.pressure,
+                                       factor == 4 ? "/rate4x" : factor == 2 ? "/rate2x" : "");
+
+                        if (verbose)
+                            std::printf ("  %-40s %12.1f %12.1f %12.2e %10.2f%s\n", name,
+                                         m.maxErrorDb, m.rmsErrorDb, m.bDivergence, m.firstExceedSeconds,
+                                         m.growing ? "  growing" : "");
+
+                        if (m.maxErrorDb > worst.maxErrorDb || worstCase.empty())
+                            worstCase = name;
+
+                        worst.maxErrorDb  = std::max (worst.maxErrorDb,  m.maxErrorDb);
+                        worst.rmsErrorDb  = std::max (worst.rmsErrorDb,  m.rmsErrorDb);
+                        worst.bDivergence = std::max (worst.bDivergence, m.bDivergence);
+                        worst.identical   = worst.identical && m.identical;
+                        growing = growing || m.growing;
+
+                        if (m.firstExceedSeconds >= 0.0 && (firstExceed < 0.0 || m.firstExceedSeconds < firstExceed))
+                            firstExceed = m.firstExceedSeconds;
+                    }
+                }
+            }
+        }
+
+        const bool pass = k.exact ? worst.identical
+                                  : (worst.maxErrorDb  <= k.maxErrorDb
+                                  && worst.rmsErrorDb  <= k.rmsErrorDb
+                                  && worst.bDivergence <= k.bDivergence);
+
+        failures += pass ? 0 : 1;
+
+        char exceeds[32] = "never";
+
+        if (firstExceed >= 0.0)
+            std::snprintf (exceeds, sizeof (exceeds), "%.2f s", firstExceed);
+
+        std::printf ("%-12s %-6s %12.1f %12.1f %12.2e %10s  %s%s\n",
+                     k.name.c_str(), pass ? "PASS" : "FAIL",
+                     worst.maxErrorDb, worst.rmsErrorDb, worst.bDivergence,
+                     k.exact ? (worst.identical ? "exact" : "differs") : exceeds,
+                     worstCase.c_str(), growing ? " (b error grows)" : "");
+
+        if (! k.exact)
+            std::printf ("%-12s %-6s %12.1f %12.1f %12.2e\n", "", "limit", k.maxErrorDb, k.rmsErrorDb, k.bDivergence);
+    }
+
+    return failures > 0 ? 1 : 0;
+}